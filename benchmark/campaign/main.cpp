@@ -0,0 +1,379 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <ctime>
+#include <cmath>
+#include "../../local_search/common/Dictionary.h"
+#include "../../local_search/common/Solvers.h"
+#include "../../include/VariadicTable.h"
+
+/*
+ * Quality versus time benchmark campaign.
+ * Runs every engine x word length x seed under a fixed time budget and reports the distribution
+ * of final sequence lengths, time-to-target curves and best length per CPU second.
+ *
+ * Build with : cmake -S . -B build && cmake --build build --target campaign
+ */
+
+/* Dictionary file (the build sets this to the repository's dictionary.txt) */
+#ifndef DICTIONARY_PATH
+#define DICTIONARY_PATH "dictionary.txt"
+#endif
+
+/*
+ * Table structure for printing the summary to console.
+ */
+typedef VariadicTable<std::string, size_t, size_t, size_t, size_t, size_t, size_t, double, double> TableFormat;
+
+/* Command line options */
+struct options_t {
+    std::vector<Algorithm> algos;
+    std::vector<int> lengths;
+    int seeds = 10;
+    uint32_t base_seed = 1;
+    int threads = 1;
+    std::string dict_path = DICTIONARY_PATH;
+    std::string output_dir;
+    solve_params_t params;
+};
+
+/* One engine run */
+struct run_t {
+    Algorithm algo;
+    int word_len;
+    uint32_t seed;
+    size_t seq_length = 0;
+    double cpu_sec = 0;
+    size_t iterations = 0;
+    bool correct = false;
+    std::vector<std::pair<double, size_t>> trace;
+};
+
+/*
+ * Final length distribution of an engine at one word length.
+ * length_per_cpu_sec: the best length divided by the CPU seconds spent on all runs.
+ */
+struct summary_t {
+    Algorithm algo;
+    int word_len;
+    size_t runs = 0;
+    size_t min = 0, median = 0, p95 = 0, max = 0;
+    double mean_cpu_sec = 0;
+    double length_per_cpu_sec = 0;
+};
+
+/* Fractions of the best known length used as targets for the time-to-target curves */
+const double target_fractions[] = {0.5, 0.75, 0.9, 0.95, 0.99, 1.0};
+
+
+void printUsage(std::ostream& out)
+{
+    out << "Usage: campaign [options]\n"
+        << "  --algos LIST          comma separated engines (default: hill,sa,random-greedy,lns)\n"
+        << "  --lengths LIST        word lengths, e.g. 4-15 or 5,7,9-11 (default: 4-15)\n"
+        << "  --seeds N             runs per engine and word length (default: 10)\n"
+        << "  --seed N              seed of the first run, run i uses seed + i (default: 1)\n"
+        << "  --time-limit SEC      search time budget per run (default: 1)\n"
+        << "  --threads N           runs executed concurrently (default: 1)\n"
+        << "  --dict PATH           dictionary file (default: " DICTIONARY_PATH ")\n"
+        << "  --output-dir DIR      write runs.csv, summary.csv, time_to_target.csv and campaign.json to DIR\n";
+}
+
+bool parseOptions(int argc, char* argv[], options_t& opts)
+{
+    opts.params.time_limit = 1;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage(std::cout);
+            std::exit(0);
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << '\n';
+            return false;
+        }
+        std::string value = argv[++i];
+
+        try {
+            if (arg == "--algos") {
+                std::stringstream ss(value);
+                std::string name;
+                while (std::getline(ss, name, ',')) {
+                    Algorithm algo;
+                    if (!parseAlgorithm(name, algo)) {
+                        std::cerr << "Unknown algorithm: " << name << '\n';
+                        return false;
+                    }
+                    opts.algos.push_back(algo);
+                }
+            } else if (arg == "--lengths") {
+                if (!parseLengths(value, opts.lengths)) {
+                    std::cerr << "Invalid word lengths: " << value << '\n';
+                    return false;
+                }
+            } else if (arg == "--seeds") {
+                opts.seeds = std::max(1, std::stoi(value));
+            } else if (arg == "--seed") {
+                opts.base_seed = std::stoul(value);
+            } else if (arg == "--time-limit") {
+                opts.params.time_limit = std::stod(value);
+            } else if (arg == "--threads") {
+                opts.threads = std::max(1, std::stoi(value));
+            } else if (arg == "--dict") {
+                opts.dict_path = value;
+            } else if (arg == "--output-dir") {
+                opts.output_dir = value;
+            } else {
+                std::cerr << "Unknown option: " << arg << '\n';
+                return false;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Invalid value for " << arg << ": " << value << '\n';
+            return false;
+        }
+    }
+
+    if (opts.algos.empty())
+        opts.algos = {Algorithm::HillClimbing, Algorithm::SimulatedAnnealing, Algorithm::RandomGreedy,
+                      Algorithm::LargeNeighbourhood};
+    if (opts.lengths.empty())
+        parseLengths("4-15", opts.lengths);
+    return true;
+}
+
+/* CPU time used by the calling thread, in seconds */
+double threadCpuSeconds()
+{
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+/*
+ * Executes one engine run on a dictionary.
+ */
+void executeRun(const dictionary_t& dict, const options_t& opts, run_t& run)
+{
+    seedRandom(run.seed);
+
+    solve_stats_t stats;
+    double cpu_start = threadCpuSeconds();
+    auto max_path = solve(run.algo, dict, opts.params, &stats);
+    run.cpu_sec = threadCpuSeconds() - cpu_start;
+
+    run.seq_length = max_path.size();
+    run.iterations = stats.iterations;
+    run.correct = testPath(max_path);
+    run.trace = std::move(stats.trace);
+}
+
+/* Nearest rank percentile of sorted values */
+size_t percentile(const std::vector<size_t>& sorted, double p)
+{
+    size_t rank = (size_t)std::ceil(p * sorted.size());
+    return sorted[std::max<size_t>(rank, 1) - 1];
+}
+
+/* Seconds until a run's trace reached target, or -1 if it never did */
+double timeToTarget(const run_t& run, size_t target)
+{
+    for (const auto& point : run.trace) {
+        if (point.second >= target)
+            return point.first;
+    }
+    return -1;
+}
+
+std::vector<summary_t> summarise(const options_t& opts, const std::vector<run_t>& runs)
+{
+    std::vector<summary_t> summaries;
+    for (int len : opts.lengths) {
+        for (Algorithm algo : opts.algos) {
+            summary_t s{algo, len};
+            std::vector<size_t> lengths;
+            for (const auto& r : runs) {
+                if (r.algo == algo && r.word_len == len) {
+                    lengths.push_back(r.seq_length);
+                    s.mean_cpu_sec += r.cpu_sec;
+                }
+            }
+            if (lengths.empty())
+                continue;
+
+            std::sort(lengths.begin(), lengths.end());
+            s.runs = lengths.size();
+            s.min = lengths.front();
+            s.median = percentile(lengths, 0.5);
+            s.p95 = percentile(lengths, 0.95);
+            s.max = lengths.back();
+            s.mean_cpu_sec /= s.runs;
+            s.length_per_cpu_sec = (s.mean_cpu_sec > 0) ? s.max / (s.mean_cpu_sec * s.runs) : 0;
+            summaries.push_back(s);
+        }
+    }
+    return summaries;
+}
+
+
+/*
+ * Writes runs.csv, summary.csv, time_to_target.csv and campaign.json.
+ * Time-to-target targets are fractions of the best length any engine found for a word length.
+ */
+bool writeResults(const options_t& opts, const std::vector<run_t>& runs, const std::vector<summary_t>& summaries)
+{
+    std::string dir = opts.output_dir + "/";
+    std::ofstream runs_csv(dir + "runs.csv");
+    std::ofstream summary_csv(dir + "summary.csv");
+    std::ofstream ttt_csv(dir + "time_to_target.csv");
+    std::ofstream json(dir + "campaign.json");
+    if (!runs_csv || !summary_csv || !ttt_csv || !json) {
+        std::cerr << "Cannot write to output directory: " << opts.output_dir << '\n';
+        return false;
+    }
+
+    runs_csv << "algo,word_len,seed,seq_length,cpu_sec,iterations,correct\n";
+    for (const auto& r : runs)
+        runs_csv << algorithmName(r.algo) << ',' << r.word_len << ',' << r.seed << ',' << r.seq_length << ','
+                 << r.cpu_sec << ',' << r.iterations << ',' << ((r.correct) ? "true" : "false") << '\n';
+
+    summary_csv << "algo,word_len,runs,min,median,p95,max,mean_cpu_sec,length_per_cpu_sec\n";
+    for (const auto& s : summaries)
+        summary_csv << algorithmName(s.algo) << ',' << s.word_len << ',' << s.runs << ',' << s.min << ','
+                    << s.median << ',' << s.p95 << ',' << s.max << ',' << s.mean_cpu_sec << ','
+                    << s.length_per_cpu_sec << '\n';
+
+    // Time-to-target: per target, the fraction of runs reaching it and their median time.
+    ttt_csv << "algo,word_len,target_fraction,target,runs_reached,fraction_reached,median_sec\n";
+    json << "{\n  \"time_limit\": " << opts.params.time_limit << ",\n  \"time_to_target\": [";
+    bool first = true;
+    for (int len : opts.lengths) {
+        size_t best = 0;
+        for (const auto& r : runs)
+            if (r.word_len == len) best = std::max(best, r.seq_length);
+
+        for (Algorithm algo : opts.algos) {
+            for (double fraction : target_fractions) {
+                size_t target = (size_t)std::ceil(fraction * best);
+                std::vector<double> times;
+                size_t total = 0;
+                for (const auto& r : runs) {
+                    if (r.algo != algo || r.word_len != len)
+                        continue;
+                    total++;
+                    double t = timeToTarget(r, target);
+                    if (t >= 0) times.push_back(t);
+                }
+                std::sort(times.begin(), times.end());
+                double median = (times.empty()) ? -1 : times[(times.size() - 1) / 2];
+                double reached = (total) ? (double)times.size() / total : 0;
+
+                ttt_csv << algorithmName(algo) << ',' << len << ',' << fraction << ',' << target << ','
+                        << times.size() << ',' << reached << ',' << median << '\n';
+                json << ((first) ? "\n    " : ",\n    ") << "{\"algo\": \"" << algorithmName(algo)
+                     << "\", \"word_len\": " << len << ", \"target_fraction\": " << fraction
+                     << ", \"target\": " << target << ", \"fraction_reached\": " << reached
+                     << ", \"median_sec\": " << median << "}";
+                first = false;
+            }
+        }
+    }
+
+    json << "\n  ],\n  \"summary\": [";
+    for (size_t i = 0; i < summaries.size(); i++) {
+        const auto& s = summaries[i];
+        json << ((i) ? ",\n    " : "\n    ") << "{\"algo\": \"" << algorithmName(s.algo)
+             << "\", \"word_len\": " << s.word_len << ", \"runs\": " << s.runs << ", \"min\": " << s.min
+             << ", \"median\": " << s.median << ", \"p95\": " << s.p95 << ", \"max\": " << s.max
+             << ", \"mean_cpu_sec\": " << s.mean_cpu_sec << ", \"length_per_cpu_sec\": " << s.length_per_cpu_sec << "}";
+    }
+
+    json << "\n  ],\n  \"runs\": [";
+    for (size_t i = 0; i < runs.size(); i++) {
+        const auto& r = runs[i];
+        json << ((i) ? ",\n    " : "\n    ") << "{\"algo\": \"" << algorithmName(r.algo)
+             << "\", \"word_len\": " << r.word_len << ", \"seed\": " << r.seed
+             << ", \"seq_length\": " << r.seq_length << ", \"cpu_sec\": " << r.cpu_sec
+             << ", \"iterations\": " << r.iterations << ", \"correct\": " << ((r.correct) ? "true" : "false")
+             << ", \"trace\": [";
+        for (size_t j = 0; j < r.trace.size(); j++)
+            json << ((j) ? ", " : "") << "[" << r.trace[j].first << ", " << r.trace[j].second << "]";
+        json << "]}";
+    }
+    json << "\n  ]\n}\n";
+    return true;
+}
+
+
+int main(int argc, char* argv[])
+{
+    options_t opts;
+    if (!parseOptions(argc, argv, opts)) {
+        printUsage(std::cerr);
+        return 1;
+    }
+
+    // Every word length is loaded once and shared (read only) between its runs.
+    std::vector<dictionary_t> dicts(opts.lengths.size());
+    for (size_t i = 0; i < opts.lengths.size(); i++) {
+        if (loadDictionary(opts.dict_path, dicts[i], opts.lengths[i]) < 0)
+            return 1;
+    }
+
+    std::vector<run_t> runs;
+    std::vector<size_t> run_list; // index into dicts for each run
+    for (size_t i = 0; i < opts.lengths.size(); i++) {
+        for (Algorithm algo : opts.algos) {
+            for (int s = 0; s < opts.seeds; s++) {
+                run_t r;
+                r.algo = algo;
+                r.word_len = opts.lengths[i];
+                r.seed = opts.base_seed + s;
+                runs.push_back(r);
+                run_list.push_back(i);
+            }
+        }
+    }
+
+    std::cout << "Running " << runs.size() << " runs (" << opts.params.time_limit << " sec each) on "
+              << opts.threads << " thread(s)...\n" << std::endl;
+
+    // Execute the runs on a pool of threads, each taking the next pending run.
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        size_t i;
+        while ((i = next++) < runs.size())
+            executeRun(dicts[run_list[i]], opts, runs[i]);
+    };
+    std::vector<std::thread> pool;
+    for (int t = 1; t < opts.threads; t++)
+        pool.emplace_back(worker);
+    worker();
+    for (auto& t : pool)
+        t.join();
+
+    std::vector<summary_t> summaries = summarise(opts, runs);
+
+    // Print summary
+    TableFormat vt({"Algorithm", "Word Length", "Runs", "Min", "Median", "P95", "Max",
+                    "Mean CPU (sec)", "Max Len / CPU sec"});
+    for (const auto& s : summaries)
+        vt.addRow(algorithmName(s.algo), s.word_len, s.runs, s.min, s.median, s.p95, s.max,
+                  s.mean_cpu_sec, s.length_per_cpu_sec);
+    vt.print(std::cout);
+
+    for (const auto& r : runs) {
+        if (!r.correct)
+            std::cerr << "Invalid sequence: " << algorithmName(r.algo) << ", word length " << r.word_len
+                      << ", seed " << r.seed << '\n';
+    }
+
+    if (!opts.output_dir.empty() && !writeResults(opts, runs, summaries))
+        return 1;
+
+    return 0;
+}
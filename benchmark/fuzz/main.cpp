@@ -0,0 +1,518 @@
+#include <iostream>
+#include <sstream>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cctype>
+#include "../../local_search/common/Dictionary.h"
+#include "../../local_search/common/Solvers.h"
+#include "../../local_search/common/Constraints.h"
+#include "../../local_search/common/TopK.h"
+#include "../../include/VariadicTable.h"
+
+/*
+ * Differential fuzz harness.
+ * Generates small random word lists (a few letters, random overlap rules, repeated words, some of mixed word lengths,
+ * some with random constraints) and runs every engine on each, with and without the kernel.
+ * Every returned sequence is checked with testPath and against the dictionary and the constraints, and its
+ * length against an exact oracle: the exact DFS (alone, and split between threads for top-K) must find the
+ * oracle's length, the other engines at most that. Prints each failure with the case that reproduces it,
+ * then the throughput of every engine. Exits with 1 if any check failed.
+ * Stripe cases then give the parallel large neighbourhood search paths of hundreds of words (too many
+ * for the oracle, so only their validity is checked): its multi-worker runs must merge the improvements of
+ * several stripes in one round somewhere, so the merge is tested on stripes that actually change at once.
+ *
+ * Build with : cmake -S . -B build && cmake --build build --target fuzz
+ */
+
+/*
+ * Table structure for printing results to console.
+ */
+typedef VariadicTable<std::string, size_t, size_t, size_t, double, double, double> TableFormat;
+typedef VariadicTable<std::string, size_t, size_t, double, size_t, size_t> StripeTableFormat;
+
+/* Chrono clock */
+typedef std::chrono::steady_clock Clock;
+
+/* Most words a case may hold (the oracle's table has 2^words entries) */
+const int MaxCaseWords = 20;
+
+/* Words of a stripe case, of StripeWordLength letters over StripeLetters letters */
+const int StripeCaseWords = 600;
+const int StripeWordLength = 5;
+const int StripeLetters = 6;
+
+/* Command line options */
+struct options_t {
+    int cases = 500;
+    uint32_t seed = 1;
+    int max_words = 12;
+    int letters = 3;
+    int max_failures = 10;
+    int stripe_cases = 20;
+    solve_params_t params;
+};
+
+/*
+ * One generated dictionary.
+ * words: the word list as the loader reads it, repeats included.
+ * word_len: the length of every word, or MixedWordLength.
+ * constraints: empty words for an unconstrained case.
+ */
+struct case_t {
+    uint32_t seed = 0;
+    overlap_rule_t rule;
+    int word_len = 0;
+    std::vector<std::string> words;
+    constraint_words_t constraints;
+};
+
+/* An engine run the way the fuzzer calls it */
+struct engine_t {
+    std::string name;
+    Algorithm algo;
+    bool kernelize;
+    bool exact;     // must find the oracle's length.
+    bool top;       // solveTopK on two threads instead of solve.
+    int workers;    // lns threads, each on stripes of at least 3 words (so the fuzz paths are split).
+};
+
+/* Totals of one engine over every case */
+struct engine_stats_t {
+    size_t runs = 0;
+    size_t failures = 0;
+    size_t optimal = 0;     // runs that found the oracle's length.
+    size_t length = 0;
+    size_t best = 0;        // sum of the oracle's lengths.
+    size_t iterations = 0;
+    size_t merged_rounds = 0;
+    size_t dropped_stripes = 0;
+    double seconds = 0;
+};
+
+const std::vector<engine_t> engines = {
+    {"dfs --exact", Algorithm::DFS, true, true, false, 1},
+    {"dfs --exact --no-kernel", Algorithm::DFS, false, true, false, 1},
+    {"dfs --exact --top 3", Algorithm::DFS, false, true, true, 1},
+    {"dfs", Algorithm::DFS, true, false, false, 1},
+    {"dfs --no-kernel", Algorithm::DFS, false, false, false, 1},
+    {"greedy", Algorithm::Greedy, true, false, false, 1},
+    {"greedy --no-kernel", Algorithm::Greedy, false, false, false, 1},
+    {"hill", Algorithm::HillClimbing, true, false, false, 1},
+    {"hill --no-kernel", Algorithm::HillClimbing, false, false, false, 1},
+    {"sa --kernel", Algorithm::SimulatedAnnealing, true, false, false, 1},
+    {"sa", Algorithm::SimulatedAnnealing, false, false, false, 1},
+    {"random-greedy", Algorithm::RandomGreedy, true, false, false, 1},
+    {"random-greedy --no-kernel", Algorithm::RandomGreedy, false, false, false, 1},
+    {"lns", Algorithm::LargeNeighbourhood, true, false, false, 1},
+    {"lns --no-kernel", Algorithm::LargeNeighbourhood, false, false, false, 1},
+    {"lns, 3 workers", Algorithm::LargeNeighbourhood, true, false, false, 3},
+    {"lns --no-kernel, 3 workers", Algorithm::LargeNeighbourhood, false, false, false, 3},
+};
+
+/* Engines run on the stripe cases */
+const std::vector<engine_t> stripe_engines = {
+    {"lns", Algorithm::LargeNeighbourhood, true, false, false, 1},
+    {"lns, 3 workers", Algorithm::LargeNeighbourhood, true, false, false, 3},
+    {"lns --no-kernel, 3 workers", Algorithm::LargeNeighbourhood, false, false, false, 3},
+};
+
+
+void printUsage(std::ostream& out)
+{
+    out << "Usage: fuzz [options]\n"
+        << "  --cases N             dictionaries to generate (default: 500)\n"
+        << "  --seed N              seed of the first case, case i uses seed + i (default: 1)\n"
+        << "  --max-words N         most words per dictionary, at most 20 (default: 12); the exact dfs\n"
+        << "                        takes exponential time, so many words over few letters are slow\n"
+        << "  --letters N           size of the alphabet words are drawn from (default: 3)\n"
+        << "  --max-attempts N      hill, random-greedy and lns failed attempts before stopping (default: 1000)\n"
+        << "  --time-limit SEC      search time budget per engine run, 0 for none (default: 0)\n"
+        << "  --max-failures N      failures printed in full (default: 10)\n"
+        << "  --stripe-cases N      long path cases for the parallel lns stripe merge, 0 for none (default: 20)\n";
+}
+
+bool parseOptions(int argc, char* argv[], options_t& opts)
+{
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage(std::cout);
+            std::exit(0);
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << '\n';
+            return false;
+        }
+        std::string value = argv[++i];
+
+        try {
+            if (arg == "--cases") {
+                opts.cases = std::max(1, std::stoi(value));
+            } else if (arg == "--seed") {
+                opts.seed = std::stoul(value);
+            } else if (arg == "--max-words") {
+                opts.max_words = std::clamp(std::stoi(value), 1, MaxCaseWords);
+            } else if (arg == "--letters") {
+                opts.letters = std::clamp(std::stoi(value), 1, 26);
+            } else if (arg == "--max-attempts") {
+                opts.params.max_attempts = std::stoul(value);
+            } else if (arg == "--time-limit") {
+                opts.params.time_limit = std::stod(value);
+            } else if (arg == "--max-failures") {
+                opts.max_failures = std::max(0, std::stoi(value));
+            } else if (arg == "--stripe-cases") {
+                opts.stripe_cases = std::max(0, std::stoi(value));
+            } else {
+                std::cerr << "Unknown option: " << arg << '\n';
+                return false;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Invalid value for " << arg << ": " << value << '\n';
+            return false;
+        }
+    }
+    return true;
+}
+
+
+/* ------------------ Case Generation ------------------------- */
+
+
+/* A named rule, or a random kK-fF-bB rule (case insensitive one time in four) */
+overlap_rule_t randomRule(std::mt19937& rng)
+{
+    static const char* named[] = {"default", "overlap3", "first-last"};
+    overlap_rule_t rule;
+    if (rng() % 2) {
+        parseRule(named[rng() % 3], rule);
+    } else {
+        rule.key_len = 1 + rng() % 3;
+        rule.front_offset = rng() % 3;
+        rule.back_offset = rule.key_len + rng() % 3;
+        rule.fold_case = rng() % 4 == 0;
+    }
+    return rule;
+}
+
+/*
+ * Generates case seed: random words (all of one length, or of mixed lengths one time in four), some of
+ * them repeated, and one time in three random constraints on them.
+ */
+case_t generateCase(uint32_t seed, const options_t& opts)
+{
+    std::mt19937 rng(seed);
+    case_t c;
+    c.seed = seed;
+    c.rule = randomRule(rng);
+
+    // Mixed lists only hold words of at least MinWordLength letters (see readWords).
+    int min_len = minWordLength(c.rule);
+    bool mixed = rng() % 4 == 0;
+    c.word_len = (mixed) ? MixedWordLength : min_len + rng() % 3;
+    size_t num_words = 1 + rng() % opts.max_words;
+    while (c.words.size() < num_words) {
+        if (!c.words.empty() && rng() % 8 == 0) {
+            c.words.push_back(c.words[rng() % c.words.size()]); // a repeat, the loader keeps one.
+            continue;
+        }
+        std::string word(((mixed) ? std::max(min_len, MinWordLength) + rng() % 4 : c.word_len), ' ');
+        for (char& letter : word) {
+            letter = 'a' + rng() % opts.letters;
+            if (c.rule.fold_case && rng() % 2)
+                letter = std::toupper(letter);
+        }
+        c.words.push_back(word);
+    }
+
+    if (rng() % 3 == 0) {
+        auto pick = [&]() { return c.words[rng() % c.words.size()]; };
+        if (rng() % 2) c.constraints.start = pick();
+        if (rng() % 3 == 0) c.constraints.end = pick();
+        for (int i = rng() % 3; i > 0; i--) c.constraints.required.push_back(pick());
+        for (int i = rng() % 3; i > 0; i--) c.constraints.forbidden.push_back(pick());
+    }
+    return c;
+}
+
+/*
+ * Generates stripe case seed: StripeCaseWords random words under the default rule. Over so few letters
+ * the words share their keys, so the greedy path runs for hundreds of words and leaves many to repair.
+ */
+case_t generateStripeCase(uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    case_t c;
+    c.seed = seed;
+    c.word_len = StripeWordLength;
+    while (c.words.size() < StripeCaseWords) {
+        std::string word(StripeWordLength, ' ');
+        for (char& letter : word)
+            letter = 'a' + rng() % StripeLetters;
+        c.words.push_back(word);
+    }
+    return c;
+}
+
+/* Loads a case the way lpws reads a word list, so repeated words must be read once */
+dictionary_t loadCase(const case_t& c)
+{
+    dictionary_t dict;
+    dict.rule = c.rule;
+    std::stringstream list;
+    for (const std::string& word : c.words)
+        list << word << '\n';
+    readWords(list, c.word_len, dict.words, dict.rule);
+    buildDictionary(dict);
+    return dict;
+}
+
+void printCase(const case_t& c, std::ostream& out)
+{
+    out << "  rule: " << ruleName(c.rule) << "\n  words:";
+    for (const std::string& word : c.words)
+        out << ' ' << word;
+    out << '\n';
+    if (!isConstrained(c.constraints))
+        return;
+    auto list = [](const std::vector<std::string>& words) {
+        std::string joined;
+        for (const std::string& word : words)
+            joined += ((joined.empty()) ? "" : ",") + word;
+        return joined;
+    };
+    out << "  constraints: start=" << c.constraints.start << " end=" << c.constraints.end
+        << " require=" << list(c.constraints.required) << " forbid=" << list(c.constraints.forbidden) << '\n';
+}
+
+
+/* ------------------ Oracle ------------------------- */
+
+
+/* True if word b can follow word a, compared letter by letter (independent of the engines' keys) */
+bool linked(std::string_view a, std::string_view b, const overlap_rule_t& rule)
+{
+    for (int i = 0; i < rule.key_len; i++) {
+        char x = a[a.size() - rule.back_offset + i];
+        char y = b[rule.front_offset + i];
+        if (rule.fold_case) {
+            x = std::tolower((unsigned char)x);
+            y = std::tolower((unsigned char)y);
+        }
+        if (x != y)
+            return false;
+    }
+    return true;
+}
+
+/*
+ * Exact length of the longest sequence of the loaded words meeting the constraints, 0 if there is none.
+ * Dynamic program over the subsets of words: ends[mask] marks the words a sequence
+ * of exactly the words in mask can end with.
+ */
+size_t oracleLength(const dictionary_t& dict, const path_constraints_t& constraints)
+{
+    size_t n = numWords(dict.words);
+    uint32_t forbidden = 0, required = 0;
+    for (uint32_t id : constraints.forbidden) forbidden |= 1u << id;
+    for (uint32_t id : constraints.required) required |= 1u << id;
+
+    std::vector<uint32_t> next(n);
+    for (size_t a = 0; a < n; a++)
+        for (size_t b = 0; b < n; b++)
+            if (a != b && !(forbidden >> b & 1) && linked(wordAt(dict.words, a), wordAt(dict.words, b), dict.rule))
+                next[a] |= 1u << b;
+
+    std::vector<uint32_t> ends(1u << n);
+    for (size_t id = 0; id < n; id++)
+        if (!(forbidden >> id & 1) && (constraints.start < 0 || (int)id == constraints.start))
+            ends[1u << id] |= 1u << id;
+
+    size_t best = 0;
+    for (uint32_t mask = 1; mask < ends.size(); mask++) {
+        if (!ends[mask])
+            continue;
+        if ((mask & required) == required && (constraints.end < 0 || ends[mask] >> constraints.end & 1))
+            best = std::max<size_t>(best, __builtin_popcount(mask));
+        for (uint32_t last = 0; last < n; last++) {
+            if (!(ends[mask] >> last & 1))
+                continue;
+            for (uint32_t free = next[last] & ~mask; free; free &= free - 1) {
+                uint32_t id = __builtin_ctz(free);
+                ends[mask | 1u << id] |= 1u << id;
+            }
+        }
+    }
+    return best;
+}
+
+
+/* ------------------ Checks ------------------------- */
+
+
+/*
+ * Returns an empty string if path is a valid sequence of the dictionary meeting the constraints,
+ * no longer than the oracle's (and as long, if exact), otherwise what is wrong with it.
+ */
+std::string checkPath(const dictionary_t& dict,
+                      const path_constraints_t* constraints,
+                      const std::list<std::string>& path,
+                      size_t best,
+                      bool exact)
+{
+    std::vector<uint32_t> ids;
+    for (const std::string& word : path) {
+        int id = findWord(dict, word);
+        if (id < 0)
+            return "word not in the dictionary: " + word;
+        ids.push_back(id);
+    }
+    if (!testPath(path, dict.rule))
+        return "not a sequence";
+    if (constraints && !path.empty() && !meetsConstraints(*constraints, ids))
+        return "breaks the constraints";
+    if (path.size() > best)
+        return "longer than the oracle's " + std::to_string(best);
+    if (exact && path.size() != best)
+        return "length " + std::to_string(path.size()) + ", the oracle's is " + std::to_string(best);
+    if (!constraints && path.empty())
+        return "empty";
+    return "";
+}
+
+/* Runs one engine on a case, returns what is wrong with its result (empty if nothing) */
+std::string runEngine(const engine_t& engine,
+                      const dictionary_t& dict,
+                      const path_constraints_t* constraints,
+                      size_t best,
+                      const options_t& opts,
+                      engine_stats_t& totals)
+{
+    solve_params_t params = opts.params;
+    params.kernelize = engine.kernelize;
+    params.exact = engine.exact;
+    params.workers = engine.workers;
+    params.min_stripe = 3;
+    params.constraints = constraints;
+
+    solve_stats_t stats;
+    std::vector<std::list<std::string>> paths;
+    auto start = Clock::now();
+    if (engine.top) {
+        paths = solveTopK(engine.algo, dict, params, 3, 0.1, 2, 1, &stats);
+    } else {
+        paths.push_back(solve(engine.algo, dict, params, &stats));
+    }
+    totals.seconds += std::chrono::duration<double>(Clock::now() - start).count();
+    totals.runs++;
+    totals.iterations += stats.iterations;
+    totals.merged_rounds += stats.merged_rounds;
+    totals.dropped_stripes += stats.dropped_stripes;
+
+    std::list<std::string> longest = (paths.empty()) ? std::list<std::string>() : paths.front();
+    totals.length += longest.size();
+    totals.best += best;
+    if (longest.size() == best)
+        totals.optimal++;
+
+    for (size_t i = 0; i < paths.size(); i++) {
+        // The exact engines must find the longest sequence, the others (and the rest of a top-K) a valid one.
+        std::string error = checkPath(dict, constraints, paths[i], best, engine.exact && i == 0);
+        if (!error.empty())
+            return error;
+    }
+    if (engine.exact && paths.empty() && best > 0)
+        return "no sequence, the oracle's is " + std::to_string(best);
+    return "";
+}
+
+
+int main(int argc, char* argv[])
+{
+    options_t opts;
+    if (!parseOptions(argc, argv, opts)) {
+        printUsage(std::cerr);
+        return 1;
+    }
+
+    std::vector<engine_stats_t> totals(engines.size());
+    size_t failures = 0;
+    for (int i = 0; i < opts.cases; i++) {
+        case_t c = generateCase(opts.seed + i, opts);
+        dictionary_t dict = loadCase(c);
+
+        // Every constraint word is in the dictionary, so resolving cannot fail.
+        path_constraints_t resolved;
+        std::string error;
+        bool constrained = isConstrained(c.constraints);
+        if (constrained)
+            resolveConstraints(dict, c.constraints, resolved, error);
+        size_t best = oracleLength(dict, resolved);
+
+        for (size_t e = 0; e < engines.size(); e++) {
+            seedRandom(c.seed);
+            error = runEngine(engines[e], dict, (constrained) ? &resolved : nullptr, best, opts, totals[e]);
+            if (error.empty())
+                continue;
+
+            totals[e].failures++;
+            if ((int)failures++ < opts.max_failures) {
+                std::cerr << "FAIL " << engines[e].name << ": " << error << " (rerun with --seed " << c.seed
+                          << " --cases 1)\n";
+                printCase(c, std::cerr);
+            }
+        }
+    }
+
+    // Stripe cases: no oracle, every word of the case bounds the length.
+    std::vector<engine_stats_t> stripe_totals(stripe_engines.size());
+    for (int i = 0; i < opts.stripe_cases; i++) {
+        case_t c = generateStripeCase(opts.seed + i);
+        dictionary_t dict = loadCase(c);
+        for (size_t e = 0; e < stripe_engines.size(); e++) {
+            seedRandom(c.seed);
+            std::string error = runEngine(stripe_engines[e], dict, nullptr, numWords(dict.words), opts, stripe_totals[e]);
+            if (error.empty())
+                continue;
+
+            stripe_totals[e].failures++;
+            if ((int)failures++ < opts.max_failures) {
+                std::cerr << "FAIL " << stripe_engines[e].name << " (stripe case): " << error
+                          << " (rerun with --seed " << c.seed << " --cases 1 --stripe-cases 1)\n";
+                printCase(c, std::cerr);
+            }
+        }
+    }
+    for (size_t e = 0; e < stripe_engines.size() && opts.stripe_cases > 0; e++) {
+        if (stripe_engines[e].workers > 1 && stripe_totals[e].merged_rounds == 0) {
+            stripe_totals[e].failures++;
+            failures++;
+            std::cerr << "FAIL " << stripe_engines[e].name << ": no round kept the improvements of more than one stripe in "
+                      << opts.stripe_cases << " stripe cases\n";
+        }
+    }
+
+    // Print summary
+    TableFormat vt({"Engine", "Runs", "Failures", "Optimal", "Length / Oracle", "Runs / sec", "Iterations / sec"});
+    for (size_t e = 0; e < engines.size(); e++) {
+        const engine_stats_t& t = totals[e];
+        vt.addRow(engines[e].name, t.runs, t.failures, t.optimal,
+                  (t.best) ? (double)t.length / t.best : 1.0,
+                  (t.seconds > 0) ? t.runs / t.seconds : 0,
+                  (t.seconds > 0) ? t.iterations / t.seconds : 0);
+    }
+    vt.print(std::cout);
+
+    if (opts.stripe_cases > 0) {
+        StripeTableFormat st({"Engine (stripe cases)", "Runs", "Failures", "Mean Length", "Merged Rounds", "Dropped Stripes"});
+        for (size_t e = 0; e < stripe_engines.size(); e++) {
+            const engine_stats_t& t = stripe_totals[e];
+            st.addRow(stripe_engines[e].name, t.runs, t.failures, (t.runs) ? (double)t.length / t.runs : 0,
+                      t.merged_rounds, t.dropped_stripes);
+        }
+        st.print(std::cout);
+    }
+
+    std::cout << opts.cases << " cases, " << opts.stripe_cases << " stripe cases, " << failures << " failures\n";
+    return (failures) ? 1 : 0;
+}
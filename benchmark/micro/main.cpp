@@ -0,0 +1,310 @@
+#include <iostream>
+#include <sstream>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include "../../local_search/common/Dictionary.h"
+#include "../../local_search/common/Solvers.h"
+#include "../../include/VariadicTable.h"
+
+/*
+ * Microbenchmarks for the path generation kernels.
+ * Each kernel is run for a number of warmup repetitions followed by timed repetitions,
+ * and the time per operation (ns/op) is reported as mean, standard deviation and minimum.
+ *
+ * Build with : cmake -S . -B build && cmake --build build --target micro
+ */
+
+/* Dictionary file (the build sets this to the repository's dictionary.txt) */
+#ifndef DICTIONARY_PATH
+#define DICTIONARY_PATH "dictionary.txt"
+#endif
+
+/*
+ * Table structure for printing results to console.
+ */
+typedef VariadicTable<std::string, size_t, size_t, double, double, double> TableFormat;
+
+/* Chrono clock */
+typedef std::chrono::steady_clock Clock;
+
+/* Command line options */
+struct options_t {
+    std::string dict_path = DICTIONARY_PATH;
+    int min_len = 4;
+    int max_len = 15;
+    int warmup = 3;
+    int reps = 10;
+    bool csv = false;
+};
+
+/* Timing of one kernel, in nanoseconds per operation */
+struct timing_t {
+    double mean = 0;
+    double stddev = 0;
+    double min = 0;
+};
+
+/* Keeps the compiler from optimising away a kernel's result */
+volatile size_t sink;
+
+
+/* The hash map bucketing buildDictionary used before the CSR adjacency (baseline for bucketWords) */
+size_t bucketWithHashMaps(const dictionary_t& dict)
+{
+    std::unordered_map<word_key_t, std::vector<uint32_t>> front, back;
+    for (uint32_t id = 0; id < dict.front_keys.size(); id++) {
+        front[dict.front_keys[id]].push_back(id);
+        back[dict.back_keys[id]].push_back(id);
+    }
+    return front.size() + back.size();
+}
+
+
+/*
+ * Runs fn (which performs ops operations) warmup times untimed, then reps times timed.
+ */
+timing_t measure(const options_t& opts, size_t ops, const std::function<void()>& fn)
+{
+    for (int i = 0; i < opts.warmup; i++)
+        fn();
+
+    std::vector<double> samples;
+    for (int i = 0; i < opts.reps; i++) {
+        auto start = Clock::now();
+        fn();
+        auto end = Clock::now();
+        samples.push_back(std::chrono::duration<double, std::nano>(end - start).count() / ops);
+    }
+
+    timing_t t;
+    t.min = samples[0];
+    for (double s : samples) {
+        t.mean += s;
+        t.min = std::min(t.min, s);
+    }
+    t.mean /= samples.size();
+    for (double s : samples)
+        t.stddev += (s - t.mean) * (s - t.mean);
+    t.stddev = std::sqrt(t.stddev / samples.size());
+    return t;
+}
+
+
+/*
+ * Benchmarks every kernel for words of size word_len.
+ */
+void benchWordLength(int word_len, const options_t& opts, TableFormat& vt)
+{
+    // Fixed seed so every run benchmarks the same work.
+    seedRandom(word_len);
+
+    dictionary_t dict;
+    if (loadDictionary(opts.dict_path, dict, word_len) <= 0)
+        return;
+    size_t num_words = numWords(dict.words);
+
+    auto add = [&](const std::string& name, size_t ops, const std::function<void()>& fn) {
+        timing_t t = measure(opts, ops, fn);
+        if (opts.csv)
+            std::cout << name << ',' << word_len << ',' << ops << ',' << t.mean << ','
+                      << t.stddev << ',' << t.min << '\n';
+        else
+            vt.addRow(name, word_len, ops, t.mean, t.stddev, t.min);
+    };
+
+    add("loadDictionary", 1, [&]() {
+        dictionary_t d;
+        sink = loadDictionary(opts.dict_path, d, word_len);
+    });
+
+    add("buildDictionary", 1, [&]() {
+        dictionary_t d;
+        d.words = dict.words;
+        buildDictionary(d);
+        sink = d.front.ids.size();
+    });
+
+    // Incremental update: swap 1% of the words (every 100th removed, as many added back
+    // reversed), against rebuilding the dictionary above.
+    word_delta_t delta;
+    for (uint32_t id = 0; id < num_words; id += 100) {
+        std::string word(wordAt(dict.words, id));
+        delta.removed.push_back(word);
+        delta.added.emplace_back(word.rbegin(), word.rend());
+    }
+    add("applyDelta (1%)", 1, [&]() {
+        dictionary_t d = dict;
+        sink = applyDelta(d, delta, word_len);
+    });
+
+    dictionary_t updated = dict;
+    applyDelta(updated, delta, word_len);
+    std::list<std::string> previous_path = pathWords(dict.words, newGreedyPath(dict).first);
+    add("repairPath (1%)", 1, [&]() {
+        sink = repairPath(updated, previous_path).size();
+    });
+
+    // The two halves of buildDictionary, against the scalar and hash map versions.
+    dictionary_t keyed;
+    keyed.words = dict.words;
+    add("extractKeys (scalar)", num_words, [&]() {
+        extractKeys(keyed, KeyExtraction::Scalar);
+        sink = keyed.back_keys.back();
+    });
+
+    if (simdKeysSupported()) {
+        add("extractKeys (simd)", num_words, [&]() {
+            extractKeys(keyed, KeyExtraction::SIMD);
+            sink = keyed.back_keys.back();
+        });
+    }
+
+    // The default rule's keys through the runtime rule path (case folding is not specialized).
+    dictionary_t folded;
+    folded.words = dict.words;
+    parseRule("k2-f1-b3-i", folded.rule);
+    add("extractKeys (runtime rule)", num_words, [&]() {
+        extractKeys(folded, KeyExtraction::Scalar);
+        sink = folded.back_keys.back();
+    });
+
+    add("bucketWords (counting sort)", num_words, [&]() {
+        bucketWords(keyed);
+        sink = keyed.front.ids.size();
+    });
+
+    add("bucketWords (hash map)", num_words, [&]() {
+        sink = bucketWithHashMaps(keyed);
+    });
+
+    add("getFrontKey", num_words, [&]() {
+        for (uint32_t id = 0; id < num_words; id++) sink = getFrontKey(wordAt(dict.words, id));
+    });
+
+    add("getBackKey", num_words, [&]() {
+        for (uint32_t id = 0; id < num_words; id++) sink = getBackKey(wordAt(dict.words, id));
+    });
+
+    // The same keys with the word length known at compile time.
+    dispatchWordLength(word_len, [&](auto n) {
+        constexpr int N = decltype(n)::value;
+        add("backKey<N>", num_words, [&]() {
+            const char* word = dict.words.chars.data();
+            for (uint32_t id = 0; id < num_words; id++, word += N) sink = backKey<N>(word);
+        });
+    });
+
+    partition_t front_partition = newPartition(dict, false);
+    partition_t back_partition = newPartition(dict, true);
+    sampler_t front_sampler = newSampler(dict, false, SampleMode::Uniform);
+    sampler_t back_sampler = newSampler(dict, true, SampleMode::Uniform);
+    path_t greedy_path = newGreedyPath(dict);
+
+    // Successor picks from every list, with the greedy path's words visited.
+    size_t picks = 100000;
+    visitPath(front_partition, greedy_path.first);
+    add("randomUnvisitedWord", picks, [&]() {
+        for (size_t i = 0; i < picks; i++)
+            sink = randomUnvisitedWord(front_partition, i % numLists(front_partition));
+    });
+    unvisitPath(front_partition, greedy_path.first);
+
+    size_t samples = 100000;
+    add("randomWordFromSampler", samples, [&]() {
+        for (size_t i = 0; i < samples; i++)
+            sink = randomWordFromSampler(front_sampler);
+    });
+
+    // One greedy traversal from a random start word (including resetting the partition).
+    size_t starts = 100;
+    add("appendGreedyPath", starts, [&]() {
+        for (size_t i = 0; i < starts; i++) {
+            path_t p;
+            p.first.push_back(randomWordFromSampler(front_sampler));
+            visitPath(front_partition, p.first);
+            appendGreedyPath(front_partition, p, false);
+            unvisitPath(front_partition, p.first);
+            sink = p.first.size();
+        }
+    });
+
+    // One local search move: backtrack half the greedy path and regrow it.
+    size_t moves = 20;
+    size_t backtrack = greedy_path.first.size() / 2;
+    add("generateRandomPath", moves, [&]() {
+        for (size_t i = 0; i < moves; i++) {
+            sink = (i % 2)
+                ? generateRandomPath(front_partition, front_sampler, greedy_path, backtrack, false).first.size()
+                : generateRandomPath(back_partition, back_sampler, greedy_path, backtrack, true).first.size();
+        }
+    });
+
+    add("generateGreedyRandomPath", moves, [&]() {
+        for (size_t i = 0; i < moves; i++) {
+            sink = (i % 2)
+                ? generateGreedyRandomPath(front_partition, front_sampler, greedy_path, backtrack, false).first.size()
+                : generateGreedyRandomPath(back_partition, back_sampler, greedy_path, backtrack, true).first.size();
+        }
+    });
+
+    // The same move with the candidate built in a path arena, as the local searches do.
+    path_arena_t path_arena;
+    add("generateGreedyRandomPath (arena)", moves, [&]() {
+        for (size_t i = 0; i < moves; i++) {
+            std::pmr::memory_resource* resource = scratchArena(path_arena);
+            sink = (i % 2)
+                ? generateGreedyRandomPath(front_partition, front_sampler, greedy_path, backtrack, false, resource).first.size()
+                : generateGreedyRandomPath(back_partition, back_sampler, greedy_path, backtrack, true, resource).first.size();
+        }
+    });
+
+    // One DFS node expansion from every word, with nothing visited.
+    add("appendSequence (dfs)", num_words, [&]() {
+        std::vector<uint32_t> s;
+        std::vector<bool> visited(num_words);
+        for (uint32_t id = 0; id < num_words; id++) {
+            appendSequence(s, id, visited, dict);
+            sink = s.size();
+        }
+    });
+}
+
+
+int main(int argc, char* argv[])
+{
+    options_t opts;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        std::string value = argv[i + 1];
+        if (arg == "--dict") opts.dict_path = value;
+        else if (arg == "--lengths") {
+            size_t dash = value.find('-');
+            opts.min_len = std::stoi(value.substr(0, dash));
+            opts.max_len = (dash == std::string::npos) ? opts.min_len : std::stoi(value.substr(dash + 1));
+        }
+        else if (arg == "--warmup") opts.warmup = std::stoi(value);
+        else if (arg == "--reps") opts.reps = std::max(1, std::stoi(value));
+        else if (arg == "--output") opts.csv = (value == "csv");
+        else {
+            std::cerr << "Usage: micro [--dict PATH] [--lengths 4-15] [--warmup N] [--reps N] [--output table|csv]\n";
+            return 1;
+        }
+    }
+
+    // Stores the data to print to console.
+    TableFormat vt({"Kernel", "Word Length", "Ops/Rep", "Mean (ns/op)", "Std Dev (ns/op)", "Min (ns/op)"});
+
+    if (opts.csv)
+        std::cout << "kernel,word_len,ops_per_rep,mean_ns,stddev_ns,min_ns\n";
+
+    for (int len = opts.min_len; len <= opts.max_len; len++) {
+        benchWordLength(len, opts, vt);
+    }
+
+    // Print results
+    if (!opts.csv)
+        vt.print(std::cout);
+
+    return 0;
+}
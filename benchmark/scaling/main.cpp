@@ -0,0 +1,329 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <filesystem>
+#include <unistd.h>
+#include "../../local_search/common/Dictionary.h"
+#include "../../local_search/common/Solvers.h"
+#include "../../local_search/common/Kernel.h"
+#include "../../local_search/common/Synthetic.h"
+#include "../../include/VariadicTable.h"
+
+/*
+ * Scaling benchmark.
+ * Sweeps synthetic word lists (see Synthetic.h) over sizes and key frequency skews and, for each list,
+ * measures the load and graph build times, the memory of the built dictionary, the kernel and every
+ * engine's search throughput under a fixed time budget. The rows are the points of the scaling curves.
+ *
+ * Build with : cmake -S . -B build && cmake --build build --target scaling
+ */
+
+/*
+ * Table structure for printing results to console.
+ */
+typedef VariadicTable<size_t, double, std::string, double, double, double, double, size_t, size_t, double> TableFormat;
+
+/* Chrono clock */
+typedef std::chrono::steady_clock Clock;
+
+/* Command line options */
+struct options_t {
+    std::vector<size_t> sizes{10000, 100000, 1000000};
+    std::vector<double> skews{0, 1};
+    std::vector<Algorithm> algos{Algorithm::DFS, Algorithm::Greedy, Algorithm::HillClimbing,
+                                 Algorithm::SimulatedAnnealing, Algorithm::RandomGreedy, Algorithm::LargeNeighbourhood};
+    synthetic_params_t synthetic;
+    std::string work_dir = std::filesystem::temp_directory_path().string();
+    std::string output_dir;
+    bool keep_lists = false;
+    solve_params_t params;
+};
+
+/*
+ * One synthetic list, loaded and built.
+ * dict_mb: bytes held by the dictionary's containers. rss_mb: resident memory of the process once it is built.
+ */
+struct point_t {
+    size_t size;
+    double skew;
+    size_t num_words = 0;
+    double gen_sec = 0, load_sec = 0, build_sec = 0, kernel_sec = 0;
+    double dict_mb = 0, rss_mb = -1;
+    size_t kernel_words = 0;
+};
+
+/* One engine run on a point */
+struct run_t {
+    Algorithm algo;
+    double search_sec = 0;
+    size_t seq_length = 0;
+    size_t iterations = 0;
+    bool correct = false;
+};
+
+
+void printUsage(std::ostream& out)
+{
+    out << "Usage: scaling [options]\n"
+        << "  --sizes LIST          comma separated word counts, k and M suffixes allowed (default: 10k,100k,1M)\n"
+        << "  --skews LIST          comma separated Zipf exponents of the key frequencies (default: 0,1)\n"
+        << "  --lengths MIX         word lengths with optional weights, e.g. 4-15 or 4-6:1,7-9:3 (default: 4-15)\n"
+        << "  --letters N           alphabet size (default: 26)\n"
+        << "  --seed N              seed of the lists and the engines (default: 1)\n"
+        << "  --algos LIST          comma separated engines (default: dfs,greedy,hill,sa,random-greedy,lns)\n"
+        << "  --time-limit SEC      search time budget per engine run (default: 1)\n"
+        << "  --no-kernel           engines search the whole dictionary instead of its kernel\n"
+        << "                        (by default every engine but sa searches the kernel)\n"
+        << "  --kernel              every engine searches the kernel, sa included\n"
+        << "  --work-dir DIR        where the lists are written (default: the temporary directory)\n"
+        << "  --keep-lists          keep the lists after the sweep\n"
+        << "  --output-dir DIR      write scaling.csv to DIR\n";
+}
+
+/* Parses a comma separated list with parse, returns false if any item is malformed */
+template <typename T, typename Parse>
+bool parseList(const std::string& arg, std::vector<T>& items, Parse parse)
+{
+    std::vector<T> parsed;
+    std::stringstream ss(arg);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        T value;
+        if (!parse(item, value))
+            return false;
+        parsed.push_back(value);
+    }
+    if (parsed.empty())
+        return false;
+    items = std::move(parsed);
+    return true;
+}
+
+bool parseOptions(int argc, char* argv[], options_t& opts)
+{
+    opts.params.time_limit = 1;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage(std::cout);
+            std::exit(0);
+        }
+        if (arg == "--no-kernel") {
+            opts.params.kernelize = false;
+            continue;
+        }
+        if (arg == "--kernel") {
+            opts.params.kernelize = true;
+            continue;
+        }
+        if (arg == "--keep-lists") {
+            opts.keep_lists = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << '\n';
+            return false;
+        }
+        std::string value = argv[++i];
+
+        try {
+            bool valid = true;
+            if (arg == "--sizes") {
+                valid = parseList(value, opts.sizes, parseCount);
+            } else if (arg == "--skews") {
+                valid = parseList(value, opts.skews, [](const std::string& item, double& skew) {
+                    skew = std::stod(item);
+                    return skew >= 0;
+                });
+            } else if (arg == "--lengths") {
+                valid = parseLengthMix(value, opts.synthetic.lengths);
+            } else if (arg == "--letters") {
+                opts.synthetic.letters = std::stoi(value);
+            } else if (arg == "--seed") {
+                opts.synthetic.seed = std::stoull(value);
+            } else if (arg == "--algos") {
+                valid = parseList(value, opts.algos, parseAlgorithm);
+            } else if (arg == "--time-limit") {
+                opts.params.time_limit = std::stod(value);
+            } else if (arg == "--work-dir") {
+                opts.work_dir = value;
+            } else if (arg == "--output-dir") {
+                opts.output_dir = value;
+            } else {
+                std::cerr << "Unknown option: " << arg << '\n';
+                return false;
+            }
+            if (!valid) {
+                std::cerr << "Invalid value for " << arg << ": " << value << '\n';
+                return false;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Invalid value for " << arg << ": " << value << '\n';
+            return false;
+        }
+    }
+
+    std::string error = checkSyntheticParams(opts.synthetic);
+    if (!error.empty()) {
+        std::cerr << "Invalid options: " << error << '\n';
+        return false;
+    }
+    return true;
+}
+
+double secondsSince(Clock::time_point start)
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+/* Bytes held by a vector's buffer */
+template <typename T>
+size_t vectorBytes(const std::vector<T>& v)
+{
+    return v.capacity() * sizeof(T);
+}
+
+/* Bytes held by a dictionary's containers (std::vector<bool> and container headers not counted) */
+size_t dictionaryBytes(const dictionary_t& dict)
+{
+    size_t bytes = dict.words.chars.capacity() + vectorBytes(dict.words.offsets);
+    for (const dict_t* lists : {&dict.front, &dict.back})
+        bytes += vectorBytes(lists->keys) + vectorBytes(lists->start) + vectorBytes(lists->ids);
+    bytes += vectorBytes(dict.front_keys) + vectorBytes(dict.back_keys);
+    bytes += vectorBytes(dict.next_row) + vectorBytes(dict.prev_row) + vectorBytes(dict.weights);
+    return bytes;
+}
+
+/* Resident memory of the process in MB (from /proc/self/statm), or -1 where it is not available */
+double residentMB()
+{
+    std::ifstream statm("/proc/self/statm");
+    size_t total, resident;
+    if (!(statm >> total >> resident))
+        return -1;
+    return resident * (double)sysconf(_SC_PAGESIZE) / (1 << 20);
+}
+
+
+/*
+ * Generates, loads and builds the list of one point, then runs every engine on it.
+ * Returns false if the list cannot be written or read.
+ */
+bool runPoint(const options_t& opts, point_t& point, std::vector<run_t>& runs)
+{
+    synthetic_params_t synthetic = opts.synthetic;
+    synthetic.num_words = point.size;
+    synthetic.skew = point.skew;
+    std::string path = opts.work_dir + "/synthetic-" + std::to_string(point.size) + "-"
+                       + std::to_string(point.skew) + "-" + std::to_string(synthetic.seed) + ".txt";
+
+    auto start = Clock::now();
+    if (writeSyntheticWords(path, synthetic) < 0)
+        return false;
+    point.gen_sec = secondsSince(start);
+
+    // A mix of lengths is searched as one combined graph.
+    int word_len = (synthetic.lengths.size() == 1) ? synthetic.lengths[0].first : MixedWordLength;
+    dictionary_t dict;
+    start = Clock::now();
+    bool read = readWords(path, word_len, dict.words);
+    point.load_sec = secondsSince(start);
+    if (!opts.keep_lists)
+        std::filesystem::remove(path);
+    if (!read)
+        return false;
+
+    start = Clock::now();
+    buildDictionary(dict);
+    point.build_sec = secondsSince(start);
+    point.num_words = numWords(dict.words);
+    point.dict_mb = dictionaryBytes(dict) / (double)(1 << 20);
+    point.rss_mb = residentMB();
+
+    start = Clock::now();
+    point.kernel_words = numWords(newKernel(dict).dict.words);
+    point.kernel_sec = secondsSince(start);
+
+    for (Algorithm algo : opts.algos) {
+        run_t run{algo};
+        seedRandom(synthetic.seed);
+        solve_stats_t stats;
+        start = Clock::now();
+        std::list<std::string> path = solve(algo, dict, opts.params, &stats);
+        run.search_sec = secondsSince(start);
+        run.seq_length = path.size();
+        run.iterations = stats.iterations;
+        run.correct = testPath(path);
+        runs.push_back(run);
+    }
+    return true;
+}
+
+bool writeResults(const options_t& opts, const std::vector<point_t>& points, const std::vector<std::vector<run_t>>& runs)
+{
+    std::ofstream csv(opts.output_dir + "/scaling.csv");
+    if (!csv) {
+        std::cerr << "Cannot write to output directory: " << opts.output_dir << '\n';
+        return false;
+    }
+
+    csv << "size,num_words,skew,algo,gen_sec,load_sec,build_sec,dict_mb,rss_mb,kernel_words,kernel_sec,"
+           "search_sec,seq_length,iterations,iterations_per_sec,correct\n";
+    for (size_t p = 0; p < points.size(); p++) {
+        const point_t& pt = points[p];
+        for (const run_t& r : runs[p]) {
+            csv << pt.size << ',' << pt.num_words << ',' << pt.skew << ',' << algorithmName(r.algo) << ','
+                << pt.gen_sec << ',' << pt.load_sec << ',' << pt.build_sec << ',' << pt.dict_mb << ','
+                << pt.rss_mb << ',' << pt.kernel_words << ',' << pt.kernel_sec << ',' << r.search_sec << ','
+                << r.seq_length << ',' << r.iterations << ',' << r.iterations / r.search_sec << ','
+                << ((r.correct) ? "true" : "false") << '\n';
+        }
+    }
+    return true;
+}
+
+
+int main(int argc, char* argv[])
+{
+    options_t opts;
+    if (!parseOptions(argc, argv, opts)) {
+        printUsage(std::cerr);
+        return 1;
+    }
+
+    std::vector<point_t> points;
+    std::vector<std::vector<run_t>> runs;
+    for (size_t size : opts.sizes) {
+        for (double skew : opts.skews) {
+            points.push_back({size, skew});
+            runs.emplace_back();
+            if (!runPoint(opts, points.back(), runs.back()))
+                return 1;
+        }
+    }
+
+    // Print summary
+    TableFormat vt({"Words", "Skew", "Algorithm", "Load (sec)", "Build (sec)", "Dict (MB)", "RSS (MB)",
+                    "Kernel Words", "Length", "Iterations / sec"});
+    for (size_t p = 0; p < points.size(); p++) {
+        const point_t& pt = points[p];
+        for (const run_t& r : runs[p])
+            vt.addRow(pt.num_words, pt.skew, algorithmName(r.algo), pt.load_sec, pt.build_sec, pt.dict_mb,
+                      pt.rss_mb, pt.kernel_words, r.seq_length, r.iterations / r.search_sec);
+    }
+    vt.print(std::cout);
+
+    for (size_t p = 0; p < points.size(); p++) {
+        for (const run_t& r : runs[p]) {
+            if (!r.correct)
+                std::cerr << "Invalid sequence: " << algorithmName(r.algo) << ", " << points[p].num_words
+                          << " words, skew " << points[p].skew << '\n';
+        }
+    }
+
+    if (!opts.output_dir.empty() && !writeResults(opts, points, runs))
+        return 1;
+
+    return 0;
+}
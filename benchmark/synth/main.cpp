@@ -0,0 +1,106 @@
+#include <iostream>
+#include "../../local_search/common/Synthetic.h"
+
+/*
+ * Synthetic dictionary generator.
+ * Writes a deterministic word list of a chosen size, length mix, alphabet and key frequency skew
+ * (see Synthetic.h), one word per line, for running the engines and benchmarks beyond dictionary.txt.
+ *
+ * Build with : cmake -S . -B build && cmake --build build --target synth
+ */
+
+/* Command line options */
+struct options_t {
+    synthetic_params_t params;
+    std::string output_path;
+};
+
+
+void printUsage(std::ostream& out)
+{
+    out << "Usage: synth [options]\n"
+        << "  --words N             distinct words to generate, k and M suffixes allowed (default: 100k)\n"
+        << "  --lengths MIX         word lengths with optional weights, e.g. 4-15 or 4-6:1,7-9:3 (default: 4-15)\n"
+        << "  --letters N           alphabet size, the first N letters of a..z (default: 26)\n"
+        << "  --skew S              Zipf exponent of the key frequencies, 0 for uniform (default: 0)\n"
+        << "  --rule NAME           overlap rule whose keys are skewed (default: default)\n"
+        << "  --seed N              the same options and seed always give the same list (default: 1)\n"
+        << "  --output PATH         file to write the words to (default: standard output)\n";
+}
+
+bool parseOptions(int argc, char* argv[], options_t& opts)
+{
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage(std::cout);
+            std::exit(0);
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << '\n';
+            return false;
+        }
+        std::string value = argv[++i];
+
+        try {
+            bool valid = true;
+            if (arg == "--words") {
+                valid = parseCount(value, opts.params.num_words);
+            } else if (arg == "--lengths") {
+                valid = parseLengthMix(value, opts.params.lengths);
+            } else if (arg == "--letters") {
+                opts.params.letters = std::stoi(value);
+            } else if (arg == "--skew") {
+                opts.params.skew = std::stod(value);
+            } else if (arg == "--rule") {
+                valid = parseRule(value, opts.params.rule);
+            } else if (arg == "--seed") {
+                opts.params.seed = std::stoull(value);
+            } else if (arg == "--output") {
+                opts.output_path = value;
+            } else {
+                std::cerr << "Unknown option: " << arg << '\n';
+                return false;
+            }
+            if (!valid) {
+                std::cerr << "Invalid value for " << arg << ": " << value << '\n';
+                return false;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Invalid value for " << arg << ": " << value << '\n';
+            return false;
+        }
+    }
+
+    std::string error = checkSyntheticParams(opts.params);
+    if (!error.empty()) {
+        std::cerr << "Invalid options: " << error << '\n';
+        return false;
+    }
+    return true;
+}
+
+
+int main(int argc, char* argv[])
+{
+    options_t opts;
+    if (!parseOptions(argc, argv, opts)) {
+        printUsage(std::cerr);
+        return 1;
+    }
+
+    long generated;
+    if (opts.output_path.empty()) {
+        std::ios::sync_with_stdio(false);
+        generated = generateWords(opts.params, [](std::string_view word) { std::cout << word << '\n'; });
+        std::cout.flush();
+    } else {
+        generated = writeSyntheticWords(opts.output_path, opts.params);
+        if (generated < 0)
+            return 1;
+    }
+
+    if ((size_t)generated < opts.params.num_words)
+        std::cerr << "Only " << generated << " distinct words fit the lengths and alphabet\n";
+    return 0;
+}
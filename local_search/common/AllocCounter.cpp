@@ -0,0 +1,89 @@
+#include "AllocCounter.h"
+#include <cstdlib>
+#include <new>
+
+/* ------------------ Allocation Accounting ------------------------- */
+
+/* Counts of the calling thread (trivially initialised, so safe to use from operator new) */
+static thread_local alloc_counts_t thread_counts;
+
+alloc_counts_t allocCounts()
+{
+    return thread_counts;
+}
+
+alloc_counts_t operator-(const alloc_counts_t& end, const alloc_counts_t& start)
+{
+    alloc_counts_t diff;
+    diff.allocations = end.allocations - start.allocations;
+    diff.frees = end.frees - start.frees;
+    diff.bytes = end.bytes - start.bytes;
+    return diff;
+}
+
+#ifdef LPWS_COUNT_ALLOCS
+
+bool allocCountingEnabled()
+{
+    return true;
+}
+
+/*
+ * Replacement global operator new/delete. The array and nothrow forms of the standard
+ * library forward to these, so every heap allocation is counted.
+ */
+
+void* operator new(std::size_t size)
+{
+    thread_counts.allocations++;
+    thread_counts.bytes += size;
+
+    void* p = std::malloc((size) ? size : 1);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void* operator new(std::size_t size, std::align_val_t align)
+{
+    thread_counts.allocations++;
+    thread_counts.bytes += size;
+
+    // aligned_alloc needs the size to be a multiple of the alignment.
+    std::size_t a = static_cast<std::size_t>(align);
+    void* p = std::aligned_alloc(a, (size) ? (size + a - 1) / a * a : a);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept
+{
+    if (!p) return;
+    thread_counts.frees++;
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    operator delete(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept
+{
+    operator delete(p);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept
+{
+    operator delete(p);
+}
+
+#else
+
+bool allocCountingEnabled()
+{
+    return false;
+}
+
+#endif
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+
+/* ------------------ Allocation Accounting ------------------------- */
+
+/*
+ * When built with LPWS_COUNT_ALLOCS, the global operator new/delete are replaced by versions
+ * that count every heap allocation of the calling thread. Otherwise every count stays zero.
+ */
+
+/* Heap allocations, frees and bytes allocated by a thread */
+struct alloc_counts_t {
+    uint64_t allocations = 0;
+    uint64_t frees = 0;
+    uint64_t bytes = 0;
+};
+
+/* True if the counting operator new/delete are installed */
+bool allocCountingEnabled();
+
+/* Counts of the calling thread since it started */
+alloc_counts_t allocCounts();
+
+/* Counts between two snapshots */
+alloc_counts_t operator-(const alloc_counts_t& end, const alloc_counts_t& start);
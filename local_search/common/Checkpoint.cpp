@@ -0,0 +1,199 @@
+#include "Checkpoint.h"
+#include "SolutionCache.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <random>
+
+/* ------------------ DFS Checkpoints ------------------------- */
+
+static const char dfs_magic[8] = {'L', 'P', 'W', 'S', 'D', 'F', 'S', '1'};
+static const uint32_t dfs_version = 3;
+
+template <typename T>
+static void writeValue(std::ostream& out, T value)
+{
+    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+static bool readValue(std::istream& in, T& value)
+{
+    return (bool)in.read(reinterpret_cast<char*>(&value), sizeof(value));
+}
+
+static void writeArray(std::ostream& out, const std::vector<uint32_t>& values)
+{
+    writeValue<uint64_t>(out, values.size());
+    out.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(uint32_t));
+}
+
+/* Reads a length prefixed array of at most max_size values */
+static bool readArray(std::istream& in, std::vector<uint32_t>& values, uint64_t max_size)
+{
+    uint64_t size;
+    if (!readValue(in, size) || size > max_size)
+        return false;
+    values.resize(size);
+    return (bool)in.read(reinterpret_cast<char*>(values.data()), size * sizeof(uint32_t));
+}
+
+bool saveDFSState(const std::string& path, const dictionary_t& dict, const dfs_state_t& state)
+{
+    std::error_code ec;
+    std::filesystem::path parent = std::filesystem::path(path).parent_path();
+    if (!parent.empty())
+        std::filesystem::create_directories(parent, ec);
+
+    std::ostringstream tmp;
+    tmp << path << '.' << std::hex << std::random_device{}() << ".tmp";
+    {
+        std::ofstream out(tmp.str(), std::ios::binary);
+        if (out.fail()) {
+            std::cerr << "Cannot write checkpoint: " << tmp.str() << '\n';
+            return false;
+        }
+        out.write(dfs_magic, sizeof(dfs_magic));
+        writeValue<uint32_t>(out, dfs_version);
+        writeValue<uint64_t>(out, dictionaryHash(dict));
+        writeValue<int32_t>(out, dict.words.word_len);
+        writeValue<int32_t>(out, dict.rule.key_len);
+        writeValue<int32_t>(out, dict.rule.front_offset);
+        writeValue<int32_t>(out, dict.rule.back_offset);
+        writeValue<int32_t>(out, dict.rule.fold_case);
+        writeValue<int32_t>(out, state.exact);
+        writeValue<uint64_t>(out, state.iterations);
+
+        // The roots not started are (marker, word) pairs, only their words are written.
+        std::vector<uint32_t> roots, frames(state.stack.begin() + state.root_base, state.stack.end());
+        for (size_t i = 1; i < state.root_base; i += 2)
+            roots.push_back(state.stack[i]);
+        writeArray(out, roots);
+        writeArray(out, frames);
+        writeArray(out, state.current_path);
+        writeArray(out, state.max_path);
+
+        std::vector<uint64_t> bits((state.visited.size() + 63) / 64, 0);
+        for (size_t i = 0; i < state.visited.size(); i++)
+            if (state.visited[i])
+                bits[i / 64] |= uint64_t(1) << (i % 64);
+        writeValue<uint64_t>(out, state.visited.size());
+        out.write(reinterpret_cast<const char*>(bits.data()), bits.size() * sizeof(uint64_t));
+        if (!out.good())
+            return false;
+    }
+
+    std::filesystem::rename(tmp.str(), path, ec);
+    if (ec) {
+        std::cerr << "Cannot write checkpoint: " << path << '\n';
+        std::filesystem::remove(tmp.str(), ec);
+        return false;
+    }
+    return true;
+}
+
+/* True if every word ID of ids is a word of the dictionary (or a backtrack marker, if allowed) */
+static bool validIds(const std::vector<uint32_t>& ids, size_t num_words, bool markers)
+{
+    for (uint32_t id : ids)
+        if (id >= num_words && !(markers && id == DFSBacktrack))
+            return false;
+    return true;
+}
+
+bool loadDFSState(const std::string& path, const dictionary_t& dict, bool exact, dfs_state_t& state)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (in.fail())
+        return false;
+
+    size_t num_words = numWords(dict.words);
+    // Above the roots, the stack holds at most a marker and a word per successor at each depth.
+    uint64_t max_stack = 2 * (uint64_t)num_words * num_words;
+
+    char magic[sizeof(dfs_magic)];
+    uint32_t version = 0;
+    uint64_t dict_hash = 0, num_visited = 0;
+    int32_t word_len = 0, saved_exact = 0;
+    int32_t rule[4] = {};
+    std::vector<uint32_t> roots, frames;
+    dfs_state_t loaded;
+    bool ok = in.read(magic, sizeof(magic)) && std::equal(magic, magic + sizeof(magic), dfs_magic)
+              && readValue(in, version) && version == dfs_version
+              && readValue(in, dict_hash) && dict_hash == dictionaryHash(dict)
+              && readValue(in, word_len) && word_len == dict.words.word_len
+              && readValue(in, rule) && rule[0] == dict.rule.key_len && rule[1] == dict.rule.front_offset
+              && rule[2] == dict.rule.back_offset && rule[3] == (int32_t)dict.rule.fold_case
+              && readValue(in, saved_exact) && (saved_exact == 0 || saved_exact == 1)
+              && readValue(in, loaded.iterations)
+              && readArray(in, roots, num_words)
+              && readArray(in, frames, max_stack)
+              && readArray(in, loaded.current_path, num_words)
+              && readArray(in, loaded.max_path, num_words)
+              && readValue(in, num_visited) && num_visited == num_words
+              && validIds(roots, num_words, false)
+              && validIds(frames, num_words, true)
+              && validIds(loaded.current_path, num_words, false)
+              && validIds(loaded.max_path, num_words, false);
+
+    std::vector<uint64_t> bits((num_words + 63) / 64);
+    ok = ok && in.read(reinterpret_cast<char*>(bits.data()), bits.size() * sizeof(uint64_t));
+    if (!ok) {
+        std::cerr << "Ignoring checkpoint of another dictionary or corrupt: " << path << '\n';
+        return false;
+    }
+    if ((bool)saved_exact != exact) {
+        std::cerr << "Ignoring checkpoint saved " << ((saved_exact) ? "with" : "without") << " --exact: " << path << '\n';
+        return false;
+    }
+    loaded.exact = exact;
+
+    for (uint32_t id : roots) {
+        loaded.stack.push_back(DFSBacktrack);
+        loaded.stack.push_back(id);
+    }
+    loaded.root_base = loaded.stack.size();
+    loaded.stack.insert(loaded.stack.end(), frames.begin(), frames.end());
+    loaded.visited.resize(num_words);
+    for (size_t i = 0; i < num_words; i++)
+        loaded.visited[i] = (bits[i / 64] >> (i % 64)) & 1;
+    state = std::move(loaded);
+    return true;
+}
+
+std::vector<dfs_state_t> splitDFSState(const dfs_state_t& state, size_t num_shards)
+{
+    std::vector<dfs_state_t> shards(std::max<size_t>(num_shards, 1));
+    for (dfs_state_t& shard : shards) {
+        shard.visited = state.visited;
+        shard.max_path = state.max_path;
+        shard.exact = state.exact;
+    }
+
+    // Roots are popped from the top, deal them out in the order they would be run.
+    size_t next = 0;
+    std::vector<std::vector<uint32_t>> roots(shards.size());
+    for (size_t i = state.root_base; i >= 2; i -= 2)
+        roots[next++ % shards.size()].push_back(state.stack[i - 1]);
+
+    for (size_t k = 0; k < shards.size(); k++) {
+        auto& s = shards[k].stack;
+        for (auto it = roots[k].rbegin(); it != roots[k].rend(); ++it) {
+            s.push_back(DFSBacktrack);
+            s.push_back(*it);
+        }
+        shards[k].root_base = s.size();
+    }
+
+    // The root in progress (its frames above root_base) stays with shard 0, the other shards do not hold its path.
+    for (size_t k = 1; k < shards.size(); k++) {
+        for (uint32_t id : state.current_path)
+            shards[k].visited[id] = false;
+    }
+    dfs_state_t& first = shards[0];
+    first.stack.insert(first.stack.end(), state.stack.begin() + state.root_base, state.stack.end());
+    first.current_path = state.current_path;
+    first.iterations = state.iterations;
+    return shards;
+}
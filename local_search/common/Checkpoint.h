@@ -0,0 +1,40 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "Solvers.h"
+
+/* ------------------ DFS Checkpoints ------------------------- */
+
+/*
+ * Binary snapshot of a depth first search (dfs_state_t), so a long run can be stopped and resumed
+ * exactly where it left off, or its remaining root words split across machines.
+ * Layout (native byte order): magic "LPWSDFS1", version, dictionary hash, word length,
+ * overlap rule (key length, front offset, back offset, case folding), exact mode, iterations,
+ * then the root words not started, the rest of the stack, the current path and the max path
+ * as length prefixed uint32 arrays, and the visited flags packed 64 to a word.
+ */
+
+/*
+ * Writes state to path (written aside, then renamed, so a crash never leaves a partial checkpoint).
+ * Returns false if the file cannot be written.
+ */
+bool saveDFSState(const std::string& path, const dictionary_t& dict, const dfs_state_t& state);
+
+/*
+ * Reads the checkpoint at path into state, for a search in exact mode or not (see dfs_state_t::exact).
+ * Returns false if there is no checkpoint, or it is corrupt, belongs to another dictionary or
+ * was saved in the other mode (reported).
+ */
+bool loadDFSState(const std::string& path, const dictionary_t& dict, bool exact, dfs_state_t& state);
+
+/*
+ * Splits the remaining work of a search into num_shards states that together cover it.
+ * The root words not started yet are dealt out round robin, the root in progress stays with shard 0.
+ * Every shard keeps the mode, the max path and the visited flags, less the path in progress outside shard 0.
+ * The default DFS never frees a visited word, so what a shard can reach depends on the roots it runs:
+ * its shards are independent heuristic runs, and the longest of their results may differ from
+ * the unsplit search's. The exact DFS (solve_params_t::exact) only has the path in progress visited,
+ * so the longest of its shards' results is the result of the unsplit search.
+ */
+std::vector<dfs_state_t> splitDFSState(const dfs_state_t& state, size_t num_shards);
@@ -0,0 +1,154 @@
+#include "Constraints.h"
+#include <sstream>
+
+/* ------------------ Constraints ------------------------- */
+
+
+bool isConstrained(const constraint_words_t& words)
+{
+    return !words.start.empty() || !words.end.empty() || !words.required.empty() || !words.forbidden.empty();
+}
+
+bool resolveConstraints(const dictionary_t& dict,
+                        const constraint_words_t& words,
+                        path_constraints_t& constraints,
+                        std::string& error)
+{
+    constraints = path_constraints_t();
+    auto lookup = [&](const std::string& word, const char* role, int& id) {
+        id = findWord(dict, word);
+        if (id < 0)
+            error = std::string(role) + " word is not in the dictionary: " + word;
+        return id >= 0;
+    };
+
+    if (!words.start.empty() && !lookup(words.start, "start", constraints.start))
+        return false;
+    if (!words.end.empty() && !lookup(words.end, "end", constraints.end))
+        return false;
+    for (const std::string& word : words.required) {
+        int id;
+        if (!lookup(word, "required", id))
+            return false;
+        if (std::find(constraints.required.begin(), constraints.required.end(), id) == constraints.required.end())
+            constraints.required.push_back(id); // a word listed twice is held once.
+    }
+    for (const std::string& word : words.forbidden) {
+        int id = findWord(dict, word);
+        if (id >= 0)
+            constraints.forbidden.push_back(id);
+    }
+    return true;
+}
+
+/*
+ * Marks every word reachable from word "from" (itself included) through words marked in "through",
+ * following the words that can come after each word (or, if backward, the words that can come before it).
+ */
+static std::vector<bool> reachable(const dictionary_t& dict,
+                                   uint32_t from,
+                                   const std::vector<bool>& through,
+                                   bool backward)
+{
+    const dict_t& lists = (backward) ? dict.back : dict.front;
+    const auto& rows = (backward) ? dict.prev_row : dict.next_row;
+
+    std::vector<bool> reached(through.size());
+    std::vector<uint32_t> queue{from};
+    reached[from] = true;
+    for (size_t head = 0; head < queue.size(); head++) {
+        int row = rows[queue[head]];
+        if (row < 0)
+            continue;
+        for (uint32_t i = lists.start[row]; i < lists.start[row+1]; i++) {
+            uint32_t id = lists.ids[i];
+            if (through[id] && !reached[id]) {
+                reached[id] = true;
+                queue.push_back(id);
+            }
+        }
+    }
+    return reached;
+}
+
+constraint_masks_t newConstraintMasks(const dictionary_t& dict,
+                                      const path_constraints_t& constraints,
+                                      bool backward)
+{
+    size_t num_words = numWords(dict.words);
+    constraint_masks_t masks;
+    masks.allowed.assign(num_words, true);
+    for (uint32_t id : constraints.forbidden)
+        masks.allowed[id] = false;
+
+    // Words off every path from the start word to the end word can never be used.
+    std::vector<bool> open = masks.allowed;
+    if (constraints.start >= 0 && open[constraints.start]) {
+        std::vector<bool> from_start = reachable(dict, constraints.start, open, false);
+        for (size_t id = 0; id < num_words; id++)
+            masks.allowed[id] = masks.allowed[id] && from_start[id];
+    }
+    if (constraints.end >= 0 && open[constraints.end]) {
+        std::vector<bool> to_end = reachable(dict, constraints.end, open, true);
+        for (size_t id = 0; id < num_words; id++)
+            masks.allowed[id] = masks.allowed[id] && to_end[id];
+    }
+    if ((constraints.start >= 0 && !open[constraints.start]) || (constraints.end >= 0 && !open[constraints.end]))
+        masks.allowed.assign(num_words, false); // a forbidden anchor.
+
+    // A required word is reached from the words that lead to it, so search against the traversal direction.
+    masks.required_index.assign(num_words, -1);
+    for (size_t r = 0; r < constraints.required.size(); r++) {
+        uint32_t id = constraints.required[r];
+        masks.required_index[id] = r;
+        if (masks.allowed[id])
+            masks.reaches.push_back(reachable(dict, id, masks.allowed, !backward));
+        else
+            masks.reaches.emplace_back(num_words, false);
+    }
+    return masks;
+}
+
+std::string checkConstraints(const dictionary_t& dict, const path_constraints_t& constraints)
+{
+    for (uint32_t id : constraints.forbidden) {
+        if ((int)id == constraints.start || (int)id == constraints.end)
+            return "an anchored word is forbidden: " + std::string(wordAt(dict.words, id));
+        for (uint32_t required : constraints.required) {
+            if (id == required)
+                return "a required word is forbidden: " + std::string(wordAt(dict.words, id));
+        }
+    }
+
+    constraint_masks_t masks = newConstraintMasks(dict, constraints, false);
+    if (constraints.start >= 0 && !masks.allowed[constraints.start])
+        return "the end word cannot be reached from the start word";
+    for (uint32_t id : constraints.required) {
+        if (!masks.allowed[id])
+            return "a required word cannot be reached between the anchors: " + std::string(wordAt(dict.words, id));
+    }
+    if (std::find(masks.allowed.begin(), masks.allowed.end(), true) == masks.allowed.end())
+        return "every word is forbidden";
+
+    // Of any two required words, the sequence passes one first, so the other must be reachable from it.
+    for (size_t a = 0; a < constraints.required.size(); a++) {
+        for (size_t b = a + 1; b < constraints.required.size(); b++) {
+            uint32_t id_a = constraints.required[a], id_b = constraints.required[b];
+            if (!masks.reaches[a][id_b] && !masks.reaches[b][id_a])
+                return "required words cannot both be reached: " + std::string(wordAt(dict.words, id_a))
+                       + ", " + std::string(wordAt(dict.words, id_b));
+        }
+    }
+    return "";
+}
+
+std::vector<std::string> splitWords(const std::string& list)
+{
+    std::vector<std::string> words;
+    std::stringstream ss(list);
+    std::string word;
+    while (std::getline(ss, word, ','))
+        if (!word.empty())
+            words.push_back(word);
+    return words;
+}
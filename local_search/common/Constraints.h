@@ -0,0 +1,90 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "PathGeneration.h"
+
+/* ------------------ Constraints ------------------------- */
+
+/*
+ * Restrictions on the sequence a search returns, as words (before they are looked up in a dictionary).
+ * start/end: the word the sequence must start/end with, empty for any.
+ * required: words the sequence must hold, in any order.
+ * forbidden: words the sequence must not hold.
+ */
+struct constraint_words_t {
+    std::string start;
+    std::string end;
+    std::vector<std::string> required;
+    std::vector<std::string> forbidden;
+};
+
+/* The same restrictions by word ID within one dictionary (start/end are -1 for any) */
+struct path_constraints_t {
+    int start = -1;
+    int end = -1;
+    std::vector<uint32_t> required;
+    std::vector<uint32_t> forbidden;
+};
+
+/*
+ * What the engines prune with, derived from the constraints for one traversal direction
+ * (forward follows a word with the words its back key leads to, backward with the words leading to it).
+ * allowed[id]: word ID may appear in the sequence at all: it is not forbidden, it can be reached
+ *   from the start word and the end word can be reached from it, without passing a forbidden word.
+ * required_index[id]: index of word ID in required, or -1.
+ * reaches[r][id]: required[r] can be reached from word ID in the traversal direction through allowed words.
+ */
+struct constraint_masks_t {
+    std::vector<bool> allowed;
+    std::vector<int> required_index;
+    std::vector<std::vector<bool>> reaches;
+};
+
+/* True if the words constrain anything */
+bool isConstrained(const constraint_words_t& words);
+
+/*
+ * Looks the constraint words up in a dictionary. Forbidden words it does not hold are ignored,
+ * and required words listed more than once are required once.
+ * Returns false (with error naming the word) if a start, end or required word is not in the dictionary.
+ */
+bool resolveConstraints(const dictionary_t& dict,
+                        const constraint_words_t& words,
+                        path_constraints_t& constraints,
+                        std::string& error);
+
+/* Builds the masks of the constraints for the given traversal direction */
+constraint_masks_t newConstraintMasks(const dictionary_t& dict,
+                                      const path_constraints_t& constraints,
+                                      bool backward);
+
+/*
+ * Returns an empty string if the reachability checks leave room for a sequence meeting
+ * the constraints, otherwise the reason there cannot be one.
+ */
+std::string checkConstraints(const dictionary_t& dict, const path_constraints_t& constraints);
+
+/* True if a sequence of word IDs meets the constraints */
+template <typename Path>
+bool meetsConstraints(const path_constraints_t& constraints, const Path& path)
+{
+    if (path.empty())
+        return false;
+    if (constraints.start >= 0 && *path.begin() != (uint32_t)constraints.start)
+        return false;
+    if (constraints.end >= 0 && *path.rbegin() != (uint32_t)constraints.end)
+        return false;
+    for (uint32_t id : constraints.required) {
+        if (std::find(path.begin(), path.end(), id) == path.end())
+            return false;
+    }
+    for (uint32_t id : constraints.forbidden) {
+        if (std::find(path.begin(), path.end(), id) != path.end())
+            return false;
+    }
+    return true;
+}
+
+/* Parses a comma separated word list (as given on the command line) */
+std::vector<std::string> splitWords(const std::string& list);
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <list>
+#include <istream>
+#include "PathGeneration.h"
+
+/* ------------------ Dictionary Loading ------------------------- */
+
+
+/* Shortest word the sequence rule applies to */
+const int MinWordLength = 4;
+
+/*
+ * Word length that selects every word of at least MinWordLength letters,
+ * so that all lengths are loaded into one combined graph.
+ */
+const int MixedWordLength = -1;
+
+/* True if a word of size letters belongs to a dictionary of words of size word_len */
+inline bool matchesWordLength(int word_len, size_t size)
+{
+    return (word_len == MixedWordLength) ? size >= (size_t)MinWordLength : size == (size_t)word_len;
+}
+
+/* Word length as printed and used in file names: the number, or "mixed" */
+std::string wordLengthName(int word_len);
+
+/*
+ * Reads every word of size word_len (see matchesWordLength) from filepath into the arena, in file order.
+ * Words too short to hold the keys of rule are skipped, and a word repeated in the file (or already
+ * in the arena) is read once, so every word has one ID.
+ * Returns false if the file cannot be opened.
+ */
+bool readWords(const std::string& filepath, int word_len, word_arena_t& words,
+               const overlap_rule_t& rule = overlap_rule_t());
+
+/* Reads whitespace separated words from a stream the same way */
+void readWords(std::istream& in, int word_len, word_arena_t& words, const overlap_rule_t& rule = overlap_rule_t());
+
+/*
+ * How extractKeys computes the keys. SIMD gathers the key letters of 8 words at a time (AVX2);
+ * it needs words of one length, the default rule and a CPU with AVX2, otherwise Scalar is used.
+ */
+enum class KeyExtraction { Scalar, SIMD };
+
+/* True if this build and CPU can extract keys with SIMD */
+bool simdKeysSupported();
+
+/*
+ * Computes the front and back key of every word of a dictionary under its rule.
+ * Word lengths 4..15 with the rules of dispatchRule are specialized, anything else takes the general path.
+ */
+void extractKeys(dictionary_t& dict, KeyExtraction method);
+
+/*
+ * Groups the words into both CSR adjacency directions by key (counting sort),
+ * and resolves every word's next_row/prev_row. Needs the keys from extractKeys.
+ */
+void bucketWords(dictionary_t& dict);
+
+/* Builds both adjacency directions of a dictionary from its words */
+void buildDictionary(dictionary_t& dict);
+
+/*
+ * Parses a list of word lengths such as "4-15" or "5,7,9-11" into lengths.
+ * "mixed" stands for MixedWordLength.
+ * Returns false if the list is malformed.
+ */
+bool parseLengths(const std::string& arg, std::vector<int>& lengths);
+
+/*
+ * Loads dictionary word of size word_len into the dictionary_t data structure, linked by dict.rule.
+ * Return number of words of size word_len, or -1 if the file cannot be opened.
+ */
+int loadDictionary(const std::string& filepath, dictionary_t& dict, int word_len);
+
+
+/* ------------------ Incremental Updates ------------------------- */
+
+
+/* Changes to a word list: words to add and words to remove, of any length */
+struct word_delta_t {
+    std::vector<std::string> added;
+    std::vector<std::string> removed;
+};
+
+/*
+ * Reads a delta file: whitespace separated words, each prefixed with '+' (add) or '-' (remove).
+ * Returns false if the file cannot be opened or holds a word without a prefix.
+ */
+bool readDelta(const std::string& filepath, word_delta_t& delta);
+
+/*
+ * Applies a delta to a built dictionary of words of size word_len (see matchesWordLength), without re-reading the word list:
+ * removals are applied first, then additions. Words of other lengths, removals of absent words and
+ * additions of present words are ignored. Surviving words keep their relative order, so their IDs
+ * only shift down past removed words, and added words get the highest IDs.
+ * Returns the number of words added or removed.
+ */
+size_t applyDelta(dictionary_t& dict, const word_delta_t& delta, int word_len);
+
+
+/* ------------------ Validation ------------------------- */
+
+
+/*
+ * Returns true if the path has no cycles and matches the sequence
+ * of previous word's 2nd last and 3rd last matching current word's
+ * 2nd and 3rd letters (or the keys of another rule).
+ */
+bool testPath(const std::list<std::string>& path, const overlap_rule_t& rule = overlap_rule_t());
@@ -0,0 +1,248 @@
+#include "Kernel.h"
+#include "Dictionary.h"
+#include <unordered_map>
+
+/* ------------------ Kernelization ------------------------- */
+
+
+/* Marks a run of words that is no longer a run of its own */
+const uint32_t NoRun = UINT32_MAX;
+
+/*
+ * A run of words taken together, and its keys (the front key of its first word, the back key of its last).
+ * into: the run it was merged into or dropped for, or itself while it is alive.
+ */
+struct run_t {
+    std::vector<uint32_t> ids;
+    word_key_t front = 0;
+    word_key_t back = 0;
+    uint32_t into = NoRun;
+};
+
+/* Alive runs by front key and by back key */
+struct run_index_t {
+    std::unordered_map<word_key_t, std::vector<uint32_t>> by_front;
+    std::unordered_map<word_key_t, std::vector<uint32_t>> by_back;
+};
+
+static bool alive(const std::vector<run_t>& runs, uint32_t r)
+{
+    return runs[r].into == r;
+}
+
+static run_index_t indexRuns(const std::vector<run_t>& runs)
+{
+    run_index_t index;
+    for (uint32_t r = 0; r < runs.size(); r++) {
+        if (alive(runs, r)) {
+            index.by_front[runs[r].front].push_back(r);
+            index.by_back[runs[r].back].push_back(r);
+        }
+    }
+    return index;
+}
+
+/*
+ * Returns the only alive run other than r listed under key, NoRun if there is none,
+ * or r itself if there are several.
+ */
+static uint32_t onlyOther(const std::vector<run_t>& runs,
+                          const std::unordered_map<word_key_t, std::vector<uint32_t>>& lists,
+                          word_key_t key,
+                          uint32_t r)
+{
+    auto it = lists.find(key);
+    if (it == lists.end())
+        return NoRun;
+    uint32_t other = NoRun;
+    for (uint32_t s : it->second) {
+        if (s == r || !alive(runs, s))
+            continue;
+        if (other != NoRun)
+            return r;
+        other = s;
+    }
+    return other;
+}
+
+/* True if run a stands for more words than run b (the earlier run on a tie) */
+static bool heavier(const std::vector<run_t>& runs, uint32_t a, uint32_t b)
+{
+    if (runs[a].ids.size() != runs[b].ids.size())
+        return runs[a].ids.size() > runs[b].ids.size();
+    return a < b;
+}
+
+/* Drops the dead ends that are not the heaviest of their kind. Returns true if any was dropped. */
+static bool stripDeadEnds(std::vector<run_t>& runs, const run_index_t& index)
+{
+    // The kept run of each kind: isolated, sinks by predecessors (front key), sources by successors (back key).
+    uint32_t isolated = NoRun;
+    std::unordered_map<word_key_t, uint32_t> sinks, sources;
+    std::vector<std::pair<uint32_t, uint32_t*>> dead_ends; // (run, the kept run of its kind).
+    auto keep = [&](uint32_t& kept, uint32_t r) {
+        if (kept == NoRun || heavier(runs, r, kept))
+            kept = r;
+    };
+
+    for (uint32_t r = 0; r < runs.size(); r++) {
+        if (!alive(runs, r))
+            continue;
+        bool preceded = onlyOther(runs, index.by_back, runs[r].front, r) != NoRun;
+        bool followed = onlyOther(runs, index.by_front, runs[r].back, r) != NoRun;
+        if (preceded && followed)
+            continue;
+
+        uint32_t* kept = (!preceded && !followed) ? &isolated
+                       : (!followed) ? &sinks.try_emplace(runs[r].front, NoRun).first->second
+                       : &sources.try_emplace(runs[r].back, NoRun).first->second;
+        keep(*kept, r);
+        dead_ends.emplace_back(r, kept);
+    }
+
+    bool dropped = false;
+    for (const auto& [r, kept] : dead_ends) {
+        if (*kept != r) {
+            runs[r].into = *kept;
+            dropped = true;
+        }
+    }
+    return dropped;
+}
+
+/*
+ * Merges every run whose only successor has it as its only predecessor with that successor
+ * (each run at most once per call). Returns true if any runs were merged.
+ */
+static bool contractChains(std::vector<run_t>& runs, const run_index_t& index)
+{
+    // Runs whose neighbourhood changed since the index was built wait for the next call.
+    std::vector<bool> touched(runs.size());
+    bool merged = false;
+    for (uint32_t r = 0; r < runs.size(); r++) {
+        if (!alive(runs, r) || touched[r])
+            continue;
+        uint32_t s = onlyOther(runs, index.by_front, runs[r].back, r);
+        if (s == NoRun || s == r || touched[s] || onlyOther(runs, index.by_back, runs[s].front, s) != r)
+            continue;
+
+        runs[r].ids.insert(runs[r].ids.end(), runs[s].ids.begin(), runs[s].ids.end());
+        runs[r].back = runs[s].back;
+        runs[s].into = r;
+        touched[r] = touched[s] = true;
+        auto next = index.by_front.find(runs[r].back);
+        if (next != index.by_front.end())
+            for (uint32_t t : next->second) touched[t] = true;
+        merged = true;
+    }
+    return merged;
+}
+
+/* The alive run r was merged into or dropped for */
+static uint32_t findRun(const std::vector<run_t>& runs, uint32_t r)
+{
+    while (!alive(runs, r))
+        r = runs[r].into;
+    return r;
+}
+
+kernel_t newKernel(const dictionary_t& dict)
+{
+    size_t num_words = numWords(dict.words);
+
+    // Every word is a run of its own, except self-loops, which share one run per key.
+    std::vector<run_t> runs;
+    std::vector<uint32_t> run_of(num_words);
+    std::unordered_map<word_key_t, uint32_t> loops;
+    for (uint32_t id = 0; id < num_words; id++) {
+        word_key_t front = dict.front_keys[id];
+        word_key_t back = dict.back_keys[id];
+        if (front == back) {
+            auto it = loops.find(front);
+            if (it != loops.end()) {
+                runs[it->second].ids.push_back(id);
+                run_of[id] = it->second;
+                continue;
+            }
+            loops[front] = runs.size();
+        }
+        run_of[id] = runs.size();
+        runs.push_back({{id}, front, back, (uint32_t)runs.size()});
+    }
+
+    // Apply the rules until none applies, indexing the runs afresh after each change.
+    while (true) {
+        if (stripDeadEnds(runs, indexRuns(runs)))
+            continue;
+        if (!contractChains(runs, indexRuns(runs)))
+            break;
+    }
+
+    // A kernel word takes the place of its run's last word in ID order, the word of the run
+    // the DFS (trying the highest IDs first) would have entered it by.
+    std::vector<std::pair<uint32_t, uint32_t>> order; // (highest word ID, run).
+    for (uint32_t r = 0; r < runs.size(); r++) {
+        if (alive(runs, r))
+            order.emplace_back(*std::max_element(runs[r].ids.begin(), runs[r].ids.end()), r);
+    }
+    std::sort(order.begin(), order.end());
+
+    kernel_t kernel;
+    kernel.dict.rule = dict.rule;
+    std::vector<uint32_t> kernel_id(runs.size(), NoRun);
+    for (const auto& [last, r] : order) {
+        kernel_id[r] = addWord(kernel.dict.words, wordAt(dict.words, runs[r].ids.front()));
+        kernel.dict.front_keys.push_back(runs[r].front);
+        kernel.dict.back_keys.push_back(runs[r].back);
+        kernel.dict.weights.push_back(runs[r].ids.size());
+        kernel.ids.insert(kernel.ids.end(), runs[r].ids.begin(), runs[r].ids.end());
+        kernel.start.push_back(kernel.ids.size());
+    }
+    bucketWords(kernel.dict);
+
+    kernel.kernel_of.resize(num_words);
+    for (uint32_t id = 0; id < num_words; id++)
+        kernel.kernel_of[id] = kernel_id[findRun(runs, run_of[id])];
+    return kernel;
+}
+
+std::vector<uint32_t> kernelPath(const kernel_t& kernel, const std::vector<uint32_t>& path)
+{
+    const dictionary_t& dict = kernel.dict;
+    std::vector<uint32_t> longest, piece;
+    std::vector<size_t> in_piece(numWords(dict.words)); // last piece (counted from 1) holding a kernel word.
+    size_t pieces = 1;
+
+    for (uint32_t id : path) {
+        uint32_t k = kernel.kernel_of[id];
+        if (!piece.empty() && piece.back() == k)
+            continue; // the next word of the same run.
+        if (piece.empty() || (in_piece[k] != pieces && dict.back_keys[piece.back()] == dict.front_keys[k])) {
+            piece.push_back(k);
+            in_piece[k] = pieces;
+            continue;
+        }
+        // The path leaves the kernel here, start a new piece.
+        if (pathWeight(dict, piece) > pathWeight(dict, longest))
+            longest = piece;
+        piece.assign(1, k);
+        in_piece[k] = ++pieces;
+    }
+    if (pathWeight(dict, piece) > pathWeight(dict, longest))
+        longest = piece;
+    return longest;
+}
+
+std::list<std::string> expandPath(const kernel_t& kernel,
+                                  const dictionary_t& dict,
+                                  const std::list<std::string>& path)
+{
+    // Each kernel word is the first word of its run.
+    std::list<std::string> words;
+    for (const std::string& word : path) {
+        uint32_t k = kernel.kernel_of[findWord(dict, word)];
+        for (uint32_t i = kernel.start[k]; i < kernel.start[k+1]; i++)
+            words.emplace_back(wordAt(dict.words, kernel.ids[i]));
+    }
+    return words;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <list>
+#include "PathGeneration.h"
+
+/* ------------------ Kernelization ------------------------- */
+
+/*
+ * A dictionary reduced before the search. Every kernel word stands for a run of words that a longest
+ * sequence can always take together, so the engines search a smaller graph without losing length:
+ *  - self-loops: the words whose front key is their back key (every word of length 4 under the default
+ *    rule) are folded into one kernel word per key, since a sequence passing the key can take them all;
+ *  - chains: a word whose only successor has it as its only predecessor is merged with that successor;
+ *  - dead ends: of the words that cannot be followed and share their predecessors (or cannot be preceded
+ *    and share their successors) only the heaviest is kept, as a sequence ends (starts) with one of them
+ *    at most. Of the words that can neither be followed nor preceded only the heaviest is kept.
+ * The rules are applied until none applies.
+ * dict: the kernel. dict.weights[k] is the number of words kernel word k stands for, its arena holds
+ *   each kernel word's first word.
+ * kernel word k expands to the word IDs ids[start[k], start[k+1]), in sequence order.
+ * kernel_of[id]: kernel word holding word ID, or for a word that was dropped, the kernel word kept in its place.
+ */
+struct kernel_t {
+    dictionary_t dict;
+    std::vector<uint32_t> start{0};
+    std::vector<uint32_t> ids;
+    std::vector<uint32_t> kernel_of;
+};
+
+/* Reduces a built dictionary to its kernel */
+kernel_t newKernel(const dictionary_t& dict);
+
+/*
+ * Maps a path of word IDs of the dictionary to kernel word IDs (e.g. a warm start path).
+ * Where the mapped path is not a sequence of the kernel (a run of the kernel taken in two visits),
+ * the longest piece that is one is kept.
+ */
+std::vector<uint32_t> kernelPath(const kernel_t& kernel, const std::vector<uint32_t>& path);
+
+/* Expands a path of kernel words (as returned by the engines) to the words of the dictionary */
+std::list<std::string> expandPath(const kernel_t& kernel,
+                                  const dictionary_t& dict,
+                                  const std::list<std::string>& path);
@@ -1,102 +1,413 @@
 #include "PathGeneration.h"
+#include <cstdio>
+#include <cctype>
+
+/* Random number generator (one per thread so engines can run concurrently) */
+thread_local std::mt19937 engine{std::random_device{}()};
+
+/* ------------------ Path Arenas ------------------------- */
+
+
+void* overflow_resource_t::do_allocate(size_t n, size_t alignment)
+{
+    bytes += n;
+    return std::pmr::new_delete_resource()->allocate(n, alignment);
+}
+
+void overflow_resource_t::do_deallocate(void* p, size_t n, size_t alignment)
+{
+    std::pmr::new_delete_resource()->deallocate(p, n, alignment);
+}
+
+bool overflow_resource_t::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+/* Rewinds an arena, first enlarging its buffer to cover whatever it overflowed to the heap */
+static void releaseArena(arena_t& arena)
+{
+    if (arena.resource && arena.upstream.bytes == 0) {
+        arena.resource->release();
+        return;
+    }
+
+    // Destroying the resource returns the overflow chunks to the heap.
+    size_t size = arena.buffer.size() + arena.upstream.bytes;
+    arena.resource.reset();
+    arena.upstream.bytes = 0;
+
+    if (size == 0) {
+        arena.resource.emplace(&arena.upstream);
+    } else {
+        arena.buffer.resize(size);
+        arena.resource.emplace(arena.buffer.data(), arena.buffer.size(), &arena.upstream);
+    }
+}
+
+std::pmr::memory_resource* scratchArena(path_arena_t& arena)
+{
+    arena_t& scratch = arena.arenas[1 - arena.kept];
+    releaseArena(scratch);
+    return &*scratch.resource;
+}
+
+void keepScratch(path_arena_t& arena)
+{
+    arena.kept = 1 - arena.kept;
+}
+
+/* Returns an empty path allocated from resource */
+static path_t newPath(std::pmr::memory_resource* resource)
+{
+    return path_t(std::piecewise_construct, std::forward_as_tuple(resource), std::forward_as_tuple(resource));
+}
+
+
+/* ------------------ Word Arena ------------------------- */
+
+
+uint32_t addWord(word_arena_t& words, std::string_view word)
+{
+    words.chars.append(word);
+    words.offsets.push_back(words.chars.size());
+
+    if (numWords(words) == 1) words.word_len = word.size();
+    else if (words.word_len != (int)word.size()) words.word_len = -1;
+    return numWords(words) - 1;
+}
+
+
+int findRow(const dict_t& dict, word_key_t key)
+{
+    auto it = std::lower_bound(dict.keys.begin(), dict.keys.end(), key);
+    if (it == dict.keys.end() || *it != key)
+        return -1;
+    return it - dict.keys.begin();
+}
+
+int findWord(const dictionary_t& dict, std::string_view word)
+{
+    if ((int)word.size() < minWordLength(dict.rule))
+        return -1;
+    int row = findRow(dict.front, getFrontKey(word, dict.rule));
+    if (row < 0)
+        return -1;
+    // Compare the back keys first, so only a few words of the row are compared in full.
+    word_key_t back_key = getBackKey(word, dict.rule);
+    for (uint32_t i = dict.front.start[row]; i < dict.front.start[row+1]; i++) {
+        uint32_t id = dict.front.ids[i];
+        if (dict.back_keys[id] == back_key && wordAt(dict.words, id) == word)
+            return id;
+    }
+    return -1;
+}
 
-/* Random number generator */
-std::random_device random_device;
-std::mt19937 engine{random_device()};
 
 /* ------------------ Helper Functions ------------------------- */
 
 
+void seedRandom(uint32_t seed)
+{
+    engine.seed(seed);
+}
+
 int randomNumber(int lower, int upper)
 {
     std::uniform_int_distribution<int> dist(lower, upper);
     return dist(engine);
 }
 
-std::string getFrontKey(const std::string& word)
+/* Packs key_len letters starting at letters, lower cased with fold_case */
+static word_key_t packRuleKey(const char* letters, const overlap_rule_t& rule)
 {
-    return word.substr(1, 2);
+    word_key_t key = 0;
+    for (int i = 0; i < rule.key_len; i++) {
+        uint8_t c = letters[i];
+        key = key << 8 | ((rule.fold_case) ? std::tolower(c) : c);
+    }
+    return key;
 }
 
-std::string getBackKey(const std::string& word)
+word_key_t getFrontKey(std::string_view word, const overlap_rule_t& rule)
 {
-    return word.substr(word.size()-3, 2);
+    return packRuleKey(word.data() + rule.front_offset, rule);
 }
 
+word_key_t getBackKey(std::string_view word, const overlap_rule_t& rule)
+{
+    return packRuleKey(word.data() + word.size() - rule.back_offset, rule);
+}
 
-std::string randomWordFromVector(const std::vector<std::string>& word_list,
-                               std::unordered_map<std::string, bool>& visited)
+bool isDefaultRule(const overlap_rule_t& rule)
 {
-    if (word_list.empty())
-        return "";
+    overlap_rule_t default_rule;
+    return rule.key_len == default_rule.key_len && rule.front_offset == default_rule.front_offset
+           && rule.back_offset == default_rule.back_offset && rule.fold_case == default_rule.fold_case;
+}
 
-    int idx = randomNumber(0, (int)word_list.size()-1);
+/* Named rules, besides the kK-fF-bB form */
+static const std::pair<const char*, overlap_rule_t> named_rules[] = {
+    {"default", overlap_rule_t{DefaultRule::key_len, DefaultRule::front_offset, DefaultRule::back_offset, false}},
+    {"overlap3", overlap_rule_t{Overlap3Rule::key_len, Overlap3Rule::front_offset, Overlap3Rule::back_offset, false}},
+    {"first-last", overlap_rule_t{FirstLastRule::key_len, FirstLastRule::front_offset, FirstLastRule::back_offset, false}},
+};
 
-    // Try 10 times to find an unvisited word.
-    // (Initially I was copying all unvisited, shuffling vector, and selecting,
-    //  but I found this method of selection gave better results).
+std::string ruleName(const overlap_rule_t& rule)
+{
+    for (const auto& named : named_rules) {
+        const overlap_rule_t& r = named.second;
+        if (rule.key_len == r.key_len && rule.front_offset == r.front_offset
+            && rule.back_offset == r.back_offset && rule.fold_case == r.fold_case)
+            return named.first;
+    }
+    return "k" + std::to_string(rule.key_len) + "-f" + std::to_string(rule.front_offset)
+           + "-b" + std::to_string(rule.back_offset) + ((rule.fold_case) ? "-i" : "");
+}
 
-    int attempts = 0;
-    while (visited.find(word_list[idx]) != visited.end()) {
-        idx = randomNumber(0, (int)word_list.size()-1);
-        if (attempts > 10)
-            return "";
-        attempts++;
+bool parseRule(const std::string& name, overlap_rule_t& rule)
+{
+    for (const auto& named : named_rules) {
+        if (name == named.first) {
+            rule = named.second;
+            return true;
+        }
     }
-    return word_list[idx];
+
+    overlap_rule_t parsed;
+    char suffix[3] = {};
+    int n = std::sscanf(name.c_str(), "k%d-f%d-b%d%2s", &parsed.key_len, &parsed.front_offset,
+                        &parsed.back_offset, suffix);
+    if (n == 4 && std::string(suffix) == "-i")
+        parsed.fold_case = true;
+    else if (n != 3)
+        return false;
+    if (parsed.key_len < 1 || parsed.key_len > MaxKeyLength || parsed.front_offset < 0
+        || parsed.back_offset < parsed.key_len)
+        return false;
+    rule = parsed;
+    return true;
 }
 
 
-std::string randomWordFromDictionary(dict_t& dict)
+partition_t newPartition(const dictionary_t& dict, bool find_back_path)
 {
-    auto random_it = dict.begin();
-    do {
-        random_it = std::next(dict.begin(), randomNumber(0, dict.size()-1));
-    } while (random_it->second.empty()); // Until we find an entry with a non empty vector.
+    const dict_t& lists = (find_back_path) ? dict.back : dict.front;
+    size_t num_words = numWords(dict.words);
+
+    partition_t partition;
+    partition.start = lists.start;
+    partition.ids = lists.ids;
+    partition.list_of.resize(num_words);
+    partition.pos.resize(num_words);
+    for (uint32_t list = 0; list < numRows(lists); list++) {
+        partition.free.push_back(rowSize(lists, list));
+        for (uint32_t i = lists.start[list]; i < lists.start[list+1]; i++) {
+            partition.list_of[lists.ids[i]] = list;
+            partition.pos[lists.ids[i]] = i;
+        }
+    }
 
-    // Choose random word.
-    auto& v = random_it->second;
-    return v[randomNumber(0, v.size()-1)];
+    // Each word's successor list was resolved when the dictionary was built.
+    partition.next_list = (find_back_path) ? dict.prev_row : dict.next_row;
+
+    // Greedy order: the size of a word's next list never changes, so each list is sorted once
+    // (stable, so words of equal weight stay in ID order).
+    auto weight = [&](uint32_t id) {
+        int list = partition.next_list[id];
+        return (list < 0) ? 0 : partition.start[list+1] - partition.start[list];
+    };
+    partition.by_weight = partition.ids;
+    partition.cursor.assign(partition.start.begin(), partition.start.end() - 1);
+    for (uint32_t list = 0; list < numLists(partition); list++) {
+        std::stable_sort(partition.by_weight.begin() + partition.start[list],
+                         partition.by_weight.begin() + partition.start[list+1],
+                         [&](uint32_t a, uint32_t b) { return weight(a) > weight(b); });
+    }
+    return partition;
 }
 
+void visitWord(partition_t& partition, uint32_t id)
+{
+    uint32_t list = partition.list_of[id];
+    auto& ids = partition.ids;
+
+    // Swap with the last unvisited word and shrink the unvisited part.
+    uint32_t last = partition.start[list] + --partition.free[list];
+    uint32_t other = ids[last];
+    std::swap(ids[partition.pos[id]], ids[last]);
+    partition.pos[other] = partition.pos[id];
+    partition.pos[id] = last;
+}
 
-/* ------------------ Random Path Generation ------------------------- */
+void unvisitWord(partition_t& partition, uint32_t id)
+{
+    uint32_t list = partition.list_of[id];
+    auto& ids = partition.ids;
+
+    // Swap with the first visited word and grow the unvisited part.
+    // The word may come before the list's greedy cursor, so the scan restarts.
+    partition.cursor[list] = partition.start[list];
+    uint32_t first = partition.start[list] + partition.free[list]++;
+    uint32_t other = ids[first];
+    std::swap(ids[partition.pos[id]], ids[first]);
+    partition.pos[other] = partition.pos[id];
+    partition.pos[id] = first;
+}
 
+void visitPath(partition_t& partition, const std::pmr::list<uint32_t>& path)
+{
+    for (uint32_t id : path)
+        visitWord(partition, id);
+}
 
-path_t newRandomPath(dict_t& dict, bool find_back_path)
+void unvisitPath(partition_t& partition, const std::pmr::list<uint32_t>& path)
 {
-    std::list<std::string> path;
-    std::unordered_map<std::string, bool> visited;
+    for (uint32_t id : path)
+        unvisitWord(partition, id);
+}
 
-    // Choose a random start word.
-    std::string word = randomWordFromDictionary(dict);
-    path.push_back(word);
-    visited[word] = true;
+int randomUnvisitedWord(const partition_t& partition, int list)
+{
+    if (list < 0 || partition.free[list] == 0)
+        return -1;
+    return partition.ids[partition.start[list] + randomNumber(0, (int)partition.free[list]-1)];
+}
 
-    // If find_back_path is false, then traverse forward,
-    // else traverse backward.
-    while (true) {
-        const std::string& key = (find_back_path) ? getFrontKey(word) : getBackKey(word);
 
-        // Next word.
-        word = randomWordFromVector(dict[key], visited);
+sampler_t newSampler(const dictionary_t& dict,
+                     bool find_back_path,
+                     SampleMode mode,
+                     const std::vector<bool>* allowed)
+{
+    const dict_t& lists = (find_back_path) ? dict.back : dict.front;
+
+    sampler_t sampler;
+    if (allowed) {
+        for (uint32_t id : lists.ids)
+            if ((*allowed)[id])
+                sampler.ids.push_back(id);
+    } else {
+        sampler.ids = lists.ids;
+    }
 
-        if (word.empty()) {
-            return std::make_pair(path, visited); // end of sequence.
+    if (mode == SampleMode::Uniform || sampler.ids.empty())
+        return sampler;
+
+    // Weight each word by the number of words that can come next in the sequence.
+    size_t n = sampler.ids.size();
+    std::vector<double> weights(n);
+    double total = 0;
+    const auto& next_rows = (find_back_path) ? dict.prev_row : dict.next_row;
+    for (size_t i = 0; i < n; i++) {
+        int row = next_rows[sampler.ids[i]];
+        weights[i] = (row < 0) ? 0 : (double)rowSize(lists, row);
+        total += weights[i];
+    }
+
+    // Every word is a dead end, fall back to uniform sampling.
+    if (total == 0)
+        return sampler;
+
+    // Build the alias table (Vose's method). Scale weights so the average is 1,
+    // then pair each under-full slot with an over-full one.
+    sampler.prob.resize(n);
+    sampler.alias.resize(n);
+    std::vector<uint32_t> small, large;
+    for (size_t i = 0; i < n; i++) {
+        weights[i] = weights[i] * n / total;
+        if (weights[i] < 1.0) small.push_back(i);
+        else large.push_back(i);
+    }
+    while (!small.empty() && !large.empty()) {
+        uint32_t s = small.back(); small.pop_back();
+        uint32_t l = large.back();
+
+        sampler.prob[s] = weights[s];
+        sampler.alias[s] = l;
+
+        weights[l] -= 1.0 - weights[s];
+        if (weights[l] < 1.0) {
+            large.pop_back();
+            small.push_back(l);
         }
+    }
+    // Whatever is left over is full (up to rounding error).
+    for (uint32_t i : large) { sampler.prob[i] = 1.0; sampler.alias[i] = i; }
+    for (uint32_t i : small) { sampler.prob[i] = 1.0; sampler.alias[i] = i; }
+
+    return sampler;
+}
 
-        if (find_back_path) path.push_front(word);
-        else path.push_back(word);
 
-        visited[word] = true;
+uint32_t randomWordFromSampler(const sampler_t& sampler)
+{
+    size_t idx = randomNumber(0, (int)sampler.ids.size()-1);
+
+    if (!sampler.prob.empty()) {
+        std::uniform_real_distribution<double> coin(0.0, 1.0);
+        if (coin(engine) >= sampler.prob[idx])
+            idx = sampler.alias[idx];
     }
+    return sampler.ids[idx];
+}
+
+
+/* ------------------ Random Path Generation ------------------------- */
+
+
+/*
+ * Randomly traverses from the end of a path until no unvisited word can follow.
+ * Every word of the path must already be visited in the partition.
+ */
+static void appendRandomPath(partition_t& partition, path_t& path_data, bool find_back_path)
+{
+    auto& path = path_data.first;
+    auto& visited = path_data.second;
+
+    uint32_t id = (find_back_path) ? path.front() : path.back();
+    while (true) {
+        int next = randomUnvisitedWord(partition, partition.next_list[id]);
 
+        if (next < 0)
+            return; // end of sequence.
+
+        id = next;
+        if (find_back_path) path.push_front(id);
+        else path.push_back(id);
+
+        visited[id] = true;
+        visitWord(partition, id);
+    }
+}
+
+path_t newRandomPath(partition_t& partition,
+                     const sampler_t& sampler,
+                     bool find_back_path,
+                     std::pmr::memory_resource* resource)
+{
+    path_t path_data = newPath(resource);
+
+    // Choose a random start word.
+    uint32_t word = randomWordFromSampler(sampler);
+    path_data.first.push_back(word);
+    path_data.second[word] = true;
+
+    // If find_back_path is false, then traverse forward,
+    // else traverse backward.
+    visitPath(partition, path_data.first);
+    appendRandomPath(partition, path_data, find_back_path);
+    unvisitPath(partition, path_data.first);
+
+    return path_data;
 }
 
-path_t generateRandomPath(dict_t& dict, 
+path_t generateRandomPath(partition_t& partition,
+                          const sampler_t& sampler,
                           const path_t& path_data,
                           size_t remove_size,
-                          bool find_back_path)
+                          bool find_back_path,
+                          std::pmr::memory_resource* resource)
 {
     auto& current_path = path_data.first;
     auto& current_visited = path_data.second;
@@ -104,11 +415,12 @@ path_t generateRandomPath(dict_t& dict,
     // If the backup length is equal to the current path size,
     // do a complete restart.
     if (current_path.size() == remove_size) {
-        return newRandomPath(dict, find_back_path);
+        return newRandomPath(partition, sampler, find_back_path, resource);
     }
 
-    std::list<std::string> new_path;
-    std::unordered_map<std::string, bool> new_visited;
+    path_t p = newPath(resource);
+    auto& new_path = p.first;
+    auto& new_visited = p.second;
 
     // Otherwise backup remove_size steps in the sequence and branch from there.
     new_path = current_path;
@@ -127,130 +439,201 @@ path_t generateRandomPath(dict_t& dict,
     }
 
     // Random traverse a new path
-    std::string word = (find_back_path) ? new_path.front() : new_path.back();
-    while (true)
-    {
-        std::string key = (find_back_path) ? getBackKey(word) : getFrontKey(word);
-        word = randomWordFromVector(dict[key], new_visited);
-
-        if (word.empty()) // End of sequence
-            return std::make_pair(new_path, new_visited); // Return new path
-
-        if(find_back_path) new_path.push_front(word);
-        else new_path.push_back(word);
+    visitPath(partition, p.first);
+    appendRandomPath(partition, p, find_back_path);
+    unvisitPath(partition, p.first);
 
-        new_visited[word] = true;
-    }
+    return p;
 }
 
 
 /* ------------------ Greedy Path Generation ------------------------- */
 
 
-void appendGreedyPath(dict_t& dict, path_t& path_data, bool find_back_path)
+void appendGreedyPath(partition_t& partition, path_t& path_data, bool find_back_path)
 {
     auto& current_path = path_data.first;
     auto& current_visited = path_data.second;
 
     // run greedy starting from last word in path (if traversing forward),
     // or from first word in path (if traversing backward).
-    std::string word = (find_back_path) ? current_path.front() : current_path.back();
+    uint32_t id = (find_back_path) ? current_path.front() : current_path.back();
 
     // Run greedy
     while (true) {
-        std::string key = (find_back_path) ? getFrontKey(word) : getBackKey(word);
-
-        auto& word_list = dict[key];
-
-        // Get word with max hanging list.
-        size_t max = 0;
-        std::string next_word;
-        for (const std::string& w : word_list) {
-            std::string possible_key = (find_back_path) ? getFrontKey(w) : getBackKey(w);
-       
-            size_t word_list_size = dict[possible_key].size();
-
-            if (word_list_size > max && current_visited.find(w) == current_visited.end()) {
-                max = word_list_size;
-                next_word = w;
-            }
-        }
-
-        // End of sequence, path_data has greedy path appended.
-        if (max == 0) {
+        int list = partition.next_list[id];
+        if (list < 0)
+            return; // End of sequence.
+
+        // Get unvisited word with max hanging list: the first unvisited word in greedy order.
+        // Words before the cursor stay visited until one is unvisited, which resets the cursor.
+        uint32_t& cursor = partition.cursor[list];
+        while (cursor < partition.start[list+1] && isVisited(partition, partition.by_weight[cursor]))
+            cursor++;
+
+        // End of sequence (no unvisited word, or none with a hanging list),
+        // path_data has greedy path appended.
+        if (cursor == partition.start[list+1] || partition.next_list[partition.by_weight[cursor]] < 0) {
             return;
         }
+        uint32_t next_id = partition.by_weight[cursor];
 
-        if (find_back_path) current_path.push_front(next_word);
-        else current_path.push_back(next_word);
+        if (find_back_path) current_path.push_front(next_id);
+        else current_path.push_back(next_id);
 
-        current_visited[next_word] = true;
-        
-        word = next_word;
+        current_visited[next_id] = true;
+        visitWord(partition, next_id);
+
+        id = next_id;
     }
 }
 
 
-path_t newGreedyPath(dict_t& front_dict, dict_t& back_dict)
+path_t newGreedyPath(const dictionary_t& dict)
 {
-    std::string word;
     // Get the front key with the max list
-    auto it = front_dict.begin();
-    auto max_it = it;
-    while (++it != front_dict.end()) {
-        if (it->second.size() > max_it->second.size()) {
-            max_it = it;
+    int max_row = 0;
+    for (int row = 1; row < (int)numRows(dict.front); row++) {
+        if (rowSize(dict.front, row) > rowSize(dict.front, max_row)) {
+            max_row = row;
         }
     }
-    std::string front_key = max_it->first;
-
-    // If the word length is 4, the front key == the back key.
-    // Therefore max sequence is contained a dict[key].
-    auto& v = front_dict[front_key];
-    if (v.front().size() == 4) {
-        path_t p;
-        p.first = std::list<std::string>(v.begin(), v.end());
-        return p;
-    }
+    word_key_t front_key = dict.front.keys[max_row];
 
     // use the front_key in the back_dict to get a word whose back key
     // is equal to front_key. This is the start word.
-    word = back_dict[front_key][0];
+    // (If there is none, start in the max list itself.)
+    int back_row = findRow(dict.back, front_key);
+    uint32_t word = (back_row < 0) ? dict.front.ids[dict.front.start[max_row]] : dict.back.ids[dict.back.start[back_row]];
 
     path_t path_data;
     path_data.first.push_back(word);
     path_data.second[word] = true;
 
     // Append a greedy path.
-    appendGreedyPath(front_dict, path_data, false);
+    partition_t partition = newPartition(dict, false);
+    visitPath(partition, path_data.first);
+    appendGreedyPath(partition, path_data, false);
 
     return path_data;
 }
 
-path_t generateGreedyRandomPath(dict_t& dict,
+/*
+ * Returns one or two unused words that chain from word "from" to word "to",
+ * or an empty vector if there are none (the shortest bridge is preferred).
+ */
+static std::vector<uint32_t> findBridge(const dictionary_t& dict, uint32_t from, uint32_t to,
+                                        const std::vector<bool>& used)
+{
+    int row = dict.next_row[from];
+    if (row < 0)
+        return {};
+
+    const uint32_t* begin = dict.front.ids.data() + dict.front.start[row];
+    const uint32_t* end = dict.front.ids.data() + dict.front.start[row+1];
+    for (const uint32_t* w = begin; w != end; w++) {
+        if (!used[*w] && dict.back_keys[*w] == dict.front_keys[to])
+            return {*w};
+    }
+
+    for (const uint32_t* w = begin; w != end; w++) {
+        int next = dict.next_row[*w];
+        if (used[*w] || next < 0)
+            continue;
+        for (uint32_t i = dict.front.start[next]; i < dict.front.start[next+1]; i++) {
+            uint32_t x = dict.front.ids[i];
+            if (x != *w && !used[x] && dict.back_keys[x] == dict.front_keys[to])
+                return {*w, x};
+        }
+    }
+    return {};
+}
+
+std::vector<uint32_t> repairPath(const dictionary_t& dict, const std::list<std::string>& path)
+{
+    // Look up the surviving words first, so no bridge reuses a word later in the path.
+    std::vector<int> ids;
+    std::vector<bool> used(numWords(dict.words), false);
+    for (const std::string& word : path) {
+        int id = findWord(dict, word);
+        ids.push_back(id);
+        if (id >= 0) used[id] = true;
+    }
+
+    // Split the surviving words into pieces that chain, closing what gaps we can.
+    std::vector<std::vector<uint32_t>> pieces(1);
+    for (int id : ids) {
+        if (id < 0)
+            continue; // removed word.
+
+        auto& piece = pieces.back();
+        if (piece.empty() || dict.back_keys[piece.back()] == dict.front_keys[id]) {
+            piece.push_back(id);
+            continue;
+        }
+
+        std::vector<uint32_t> bridge = findBridge(dict, piece.back(), id, used);
+        if (!bridge.empty()) {
+            for (uint32_t w : bridge)
+                used[w] = true;
+            piece.insert(piece.end(), bridge.begin(), bridge.end());
+            piece.push_back(id);
+        } else {
+            pieces.push_back({(uint32_t)id});
+        }
+    }
+
+    auto longest = std::max_element(pieces.begin(), pieces.end(),
+        [](const auto& a, const auto& b) { return a.size() < b.size(); });
+    if (longest->empty())
+        return {};
+
+    path_t path_data;
+    for (uint32_t id : *longest) {
+        path_data.first.push_back(id);
+        path_data.second[id] = true;
+    }
+
+    // Extend the kept piece greedily, forward then backward.
+    partition_t front_partition = newPartition(dict, false);
+    visitPath(front_partition, path_data.first);
+    appendGreedyPath(front_partition, path_data, false);
+
+    partition_t back_partition = newPartition(dict, true);
+    visitPath(back_partition, path_data.first);
+    appendGreedyPath(back_partition, path_data, true);
+
+    return std::vector<uint32_t>(path_data.first.begin(), path_data.first.end());
+}
+
+path_t generateGreedyRandomPath(partition_t& partition,
+                                const sampler_t& sampler,
                                 const path_t& path_data,
                                 size_t remove_size,
-                                bool find_back_path)
+                                bool find_back_path,
+                                std::pmr::memory_resource* resource)
 {
     auto& current_path = path_data.first;
     auto& current_visited = path_data.second;
 
-    std::list<std::string> new_path;
-    std::unordered_map<std::string, bool> new_visited;
+    path_t p = newPath(resource);
+    auto& new_path = p.first;
+    auto& new_visited = p.second;
 
     // If the backup length is equal to the current path size,
     // do a complete restart, starting at a random word in the dictionary.
     if (current_path.size() == remove_size) {
-        std::string word = randomWordFromDictionary(dict);
+        uint32_t word = randomWordFromSampler(sampler);
 
         if (find_back_path) new_path.push_front(word);
         else new_path.push_back(word);
 
         new_visited[word] = true;
 
-        path_t new_path_data = std::make_pair(new_path, new_visited);
-        appendGreedyPath(dict, new_path_data, find_back_path);
-        return new_path_data;
+        visitPath(partition, p.first);
+        appendGreedyPath(partition, p, find_back_path);
+        unvisitPath(partition, p.first);
+        return p;
     }
 
     // Otherwise backup remove_size steps in the sequence and branch from there.
@@ -266,21 +649,24 @@ path_t generateGreedyRandomPath(dict_t& dict,
         }
     }
 
-    std::string word = (find_back_path) ? new_path.front() : new_path.back();
-    std::string key = (find_back_path) ? getFrontKey(word) : getBackKey(word);
+    visitPath(partition, p.first);
+
+    uint32_t id = (find_back_path) ? p.first.front() : p.first.back();
 
     // Random starting word
-    word = randomWordFromVector(dict[key], new_visited);
-    if (word.empty())
-        return std::make_pair(new_path, new_visited); // end of sequence.
+    int next = randomUnvisitedWord(partition, partition.next_list[id]);
+    if (next >= 0) {
+        if (find_back_path) p.first.push_front(next);
+        else p.first.push_back(next);
 
-    if (find_back_path) new_path.push_front(word);
-    else new_path.push_back(word);
+        p.second[next] = true;
+        visitWord(partition, next);
 
-    new_visited[word] = true;
+        appendGreedyPath(partition, p, find_back_path);
+    }
 
-    path_t p = std::make_pair(new_path, new_visited);
-    appendGreedyPath(dict, p, find_back_path);
+    // Leave the partition fully unvisited for the next caller.
+    unvisitPath(partition, p.first);
 
     return p;
-}
\ No newline at end of file
+}
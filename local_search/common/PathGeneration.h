@@ -6,49 +6,425 @@
 #include <list>
 #include <algorithm>
 #include <random>
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <type_traits>
+#include <memory_resource>
+#include <optional>
 
-typedef std::unordered_map<std::string, std::vector<std::string>> dict_t;
+/*
+ * Every word of a dictionary, stored once: the letters of all words back to back.
+ * Word ID i spans chars[offsets[i], offsets[i+1]). IDs follow the order words were added.
+ * word_len is the length shared by every word (0 while empty, -1 if lengths differ), in which
+ * case word i is the fixed size record chars[i*word_len, (i+1)*word_len).
+ */
+struct word_arena_t {
+    std::string chars;
+    std::vector<uint32_t> offsets{0};
+    int word_len = 0;
+};
+
+/* A key of up to 4 letters packed into 32 bits, one byte per letter, last letter in the low byte */
+typedef uint32_t word_key_t;
+
+/*
+ * Which letters link two words: a word's front key (key_len letters starting front_offset letters
+ * from its start) must equal the previous word's back key (key_len letters starting back_offset
+ * letters before its end). With fold_case, letters are compared case insensitively.
+ * The default rule links the 2nd/3rd letters to the previous word's 3rd last/2nd last letters.
+ */
+struct overlap_rule_t {
+    int key_len = 2;
+    int front_offset = 1;
+    int back_offset = 3;
+    bool fold_case = false;
+};
+
+/*
+ * Words grouped by key in compressed sparse row form, one row per key present (in key order).
+ * Row r holds the IDs of the words with key keys[r], in ID order: ids[start[r], start[r+1]).
+ */
+struct dict_t {
+    std::vector<word_key_t> keys;
+    std::vector<uint32_t> start{0};
+    std::vector<uint32_t> ids;
+};
+
+/*
+ * A loaded dictionary. The words live in the arena, both adjacency directions refer to them by ID.
+ * rule: how words link, which sets the keys below.
+ * front: key is a word's front key (2nd and 3rd letters by default).
+ * back: key is a word's back key (3rd last and 2nd last letters by default).
+ * front_keys/back_keys: word ID -> the word's front/back key.
+ * next_row[id]: row of front holding the words that can follow word ID, or -1 if there are none.
+ * prev_row[id]: row of back holding the words that can precede word ID, or -1 if there are none.
+ * weights[id]: number of words word ID stands for in a kernel (see Kernel.h), empty if every word stands for itself.
+ */
+struct dictionary_t {
+    overlap_rule_t rule;
+    word_arena_t words;
+    dict_t front;
+    dict_t back;
+    std::vector<word_key_t> front_keys;
+    std::vector<word_key_t> back_keys;
+    std::vector<int> next_row;
+    std::vector<int> prev_row;
+    std::vector<uint32_t> weights;
+};
+
+/*
+ * A path of word IDs and its visited set. Both containers take their nodes from a memory resource
+ * (the heap by default), so the local searches can build candidate paths in an arena.
+ */
+typedef std::pair<std::pmr::list<uint32_t>, std::pmr::unordered_map<uint32_t, bool>> path_t;
+
+/*
+ * Distribution used when picking a random word from the whole dictionary.
+ * Uniform: every word is equally likely.
+ * Degree: words are picked proportionally to the number of words that can follow them.
+ */
+enum class SampleMode { Uniform, Degree };
+
+/*
+ * Flat array of every word ID in a dictionary so that a random word can be picked in O(1).
+ * For weighted sampling "prob" and "alias" hold an alias table over the
+ * indices of "ids" (both are empty for uniform sampling).
+ */
+struct sampler_t {
+    std::vector<uint32_t> ids;
+    std::vector<double> prob;
+    std::vector<uint32_t> alias;
+};
+
+/*
+ * Adjacency lists of a dictionary with every list partitioned as [unvisited | visited].
+ * Visiting a word swaps it to the end of the unvisited part of its list, so picking a random
+ * unvisited word, visiting and unvisiting are all O(1).
+ * List l holds the word IDs ids[start[l], start[l+1]), of which the first free[l] are unvisited.
+ * list_of[id] is the list holding word ID, pos[id] is its index in ids.
+ * next_list[id] is the list of words that can come after word ID in the traversal
+ * direction, or -1 if there are none.
+ * by_weight holds every list's words again (laid out like ids) in decreasing order of the size
+ * of their next list, the order greedy steps pick in. Every word of by_weight[start[l], cursor[l])
+ * is visited, so a greedy step resumes its scan of a list from the list's cursor.
+ */
+struct partition_t {
+    std::vector<uint32_t> start;
+    std::vector<uint32_t> ids;
+    std::vector<uint32_t> free;
+    std::vector<uint32_t> list_of;
+    std::vector<uint32_t> pos;
+    std::vector<int> next_list;
+    std::vector<uint32_t> by_weight;
+    std::vector<uint32_t> cursor;
+};
+
+/* ------------------ Path Arenas ------------------------- */
+
+/* Upstream of an arena: allocates from the heap and counts the bytes the arena outgrew its buffer by */
+struct overflow_resource_t : std::pmr::memory_resource {
+    size_t bytes = 0;
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+};
+
+/*
+ * Monotonic arena over a reusable buffer. Deallocation is a no-op and releasing the arena
+ * rewinds it to the start of its buffer, so an arena that fits its buffer never touches the heap.
+ * If the arena outgrew its buffer since the last release, the buffer is enlarged on release.
+ */
+struct arena_t {
+    std::vector<std::byte> buffer;
+    overflow_resource_t upstream;
+    std::optional<std::pmr::monotonic_buffer_resource> resource;
+};
+
+/*
+ * The pair of arenas a local search builds its paths in (one per thread).
+ * The path the search keeps lives in arenas[kept], candidates are built in the other arena,
+ * which is released wholesale before every candidate. Keeping a candidate swaps the roles,
+ * so accepting a path moves it rather than copying it.
+ */
+struct path_arena_t {
+    arena_t arenas[2];
+    int kept = 0;
+};
+
+/* Releases the arena not holding the kept path and returns it for building the next candidate */
+std::pmr::memory_resource* scratchArena(path_arena_t& arena);
+
+/* Records that the kept path is now the candidate built in the last scratch arena */
+void keepScratch(path_arena_t& arena);
+
+
+/* ------------------ Word Arena ------------------------- */
+
+/* Appends a word to the arena and returns its ID */
+uint32_t addWord(word_arena_t& words, std::string_view word);
+
+/* Returns the word with the given ID (valid until the next word is added) */
+inline std::string_view wordAt(const word_arena_t& words, uint32_t id)
+{
+    return std::string_view(words.chars).substr(words.offsets[id], words.offsets[id+1] - words.offsets[id]);
+}
+
+inline size_t numWords(const word_arena_t& words)
+{
+    return words.offsets.size() - 1;
+}
+
+inline size_t numRows(const dict_t& dict)
+{
+    return dict.keys.size();
+}
+
+inline size_t rowSize(const dict_t& dict, int row)
+{
+    return dict.start[row+1] - dict.start[row];
+}
+
+/* Returns the row holding key, or -1 if no word has the key */
+int findRow(const dict_t& dict, word_key_t key);
+
+/* Returns the ID of a word (found through its front key's row), or -1 if it is not in the dictionary */
+int findWord(const dictionary_t& dict, std::string_view word);
+
+/* Number of words a word stands for (1 unless the dictionary is a kernel) */
+inline size_t wordWeight(const dictionary_t& dict, uint32_t id)
+{
+    return (dict.weights.empty()) ? 1 : dict.weights[id];
+}
+
+/* Length of a path of word IDs in words it stands for: the sum of its word weights */
+template <typename Path>
+size_t pathWeight(const dictionary_t& dict, const Path& path)
+{
+    if (dict.weights.empty())
+        return path.size();
+    size_t weight = 0;
+    for (uint32_t id : path)
+        weight += dict.weights[id];
+    return weight;
+}
+
+/* Copies the words of a path of word IDs out of the arena */
+template <typename Path>
+std::list<std::string> pathWords(const word_arena_t& words, const Path& path)
+{
+    std::list<std::string> out;
+    for (uint32_t id : path)
+        out.emplace_back(wordAt(words, id));
+    return out;
+}
+
+
+/* ------------------ Word Keys ------------------------- */
+
+/* Longest key a rule can have (letters of a word_key_t) */
+const int MaxKeyLength = 4;
+
+constexpr word_key_t packKey(char first, char second)
+{
+    return (word_key_t)((uint8_t)first << 8 | (uint8_t)second);
+}
+
+/* Packs the K letters starting at letters, the first letter in the highest byte */
+template <int K>
+constexpr word_key_t packLetters(const char* letters)
+{
+    word_key_t key = 0;
+    for (int i = 0; i < K; i++)
+        key = key << 8 | (uint8_t)letters[i];
+    return key;
+}
+
+/* An overlap rule known at compile time (without case folding) */
+template <int K, int Front, int Back>
+struct static_rule_t {
+    static constexpr int key_len = K;
+    static constexpr int front_offset = Front;
+    static constexpr int back_offset = Back;
+    static constexpr int min_len = (Front + K > Back) ? Front + K : Back;
+};
+
+/* The rules the engines are specialized for */
+typedef static_rule_t<2, 1, 3> DefaultRule;   // 2nd/3rd letters follow 3rd last/2nd last letters.
+typedef static_rule_t<3, 0, 3> Overlap3Rule;  // first 3 letters follow the last 3 letters.
+typedef static_rule_t<1, 0, 1> FirstLastRule; // first letter follows the last letter.
+
+/* Key of a word of length N, with the rule and letter offsets known at compile time */
+template <int N, typename Rule = DefaultRule>
+constexpr word_key_t frontKey(const char* word)
+{
+    static_assert(N >= Rule::min_len && N >= 4, "words are at least 4 letters and hold both keys");
+    return packLetters<Rule::key_len>(word + Rule::front_offset);
+}
+
+template <int N, typename Rule = DefaultRule>
+constexpr word_key_t backKey(const char* word)
+{
+    static_assert(N >= Rule::min_len && N >= 4, "words are at least 4 letters and hold both keys");
+    return packLetters<Rule::key_len>(word + N - Rule::back_offset);
+}
+
+/*
+ * Calls fn(Rule()) when rule is one of the rules above, so that fn can be specialized on it.
+ * Returns false for any other rule (or with case folding).
+ */
+template <typename Fn>
+bool dispatchRule(const overlap_rule_t& rule, Fn&& fn)
+{
+    auto is = [&](auto r) {
+        using R = decltype(r);
+        return !rule.fold_case && rule.key_len == R::key_len
+               && rule.front_offset == R::front_offset && rule.back_offset == R::back_offset;
+    };
+    if (is(DefaultRule())) { fn(DefaultRule()); return true; }
+    if (is(Overlap3Rule())) { fn(Overlap3Rule()); return true; }
+    if (is(FirstLastRule())) { fn(FirstLastRule()); return true; }
+    return false;
+}
+
+/* True if rule is the default rule */
+bool isDefaultRule(const overlap_rule_t& rule);
+
+/* Shortest word that holds both keys of a rule */
+inline int minWordLength(const overlap_rule_t& rule)
+{
+    return std::max(rule.front_offset + rule.key_len, rule.back_offset);
+}
+
+/*
+ * Name of a rule, used in output and as part of cache keys: "default", "overlap3", "first-last",
+ * or "kK-fF-bB" (key length, front offset, back offset) with "-i" appended for case folding.
+ */
+std::string ruleName(const overlap_rule_t& rule);
+
+/*
+ * Parses a rule name (see ruleName) into rule.
+ * Returns false if the name is malformed or the rule is invalid (key length 1..4, offsets within the word).
+ */
+bool parseRule(const std::string& name, overlap_rule_t& rule);
+
+/*
+ * Calls fn(std::integral_constant<int, N>()) when word_len is a length N in 4..15,
+ * so that fn can be specialized on the word length. Returns false for any other length.
+ */
+template <typename Fn>
+bool dispatchWordLength(int word_len, Fn&& fn)
+{
+    switch (word_len) {
+        case 4: fn(std::integral_constant<int, 4>()); return true;
+        case 5: fn(std::integral_constant<int, 5>()); return true;
+        case 6: fn(std::integral_constant<int, 6>()); return true;
+        case 7: fn(std::integral_constant<int, 7>()); return true;
+        case 8: fn(std::integral_constant<int, 8>()); return true;
+        case 9: fn(std::integral_constant<int, 9>()); return true;
+        case 10: fn(std::integral_constant<int, 10>()); return true;
+        case 11: fn(std::integral_constant<int, 11>()); return true;
+        case 12: fn(std::integral_constant<int, 12>()); return true;
+        case 13: fn(std::integral_constant<int, 13>()); return true;
+        case 14: fn(std::integral_constant<int, 14>()); return true;
+        case 15: fn(std::integral_constant<int, 15>()); return true;
+    }
+    return false;
+}
 
-typedef std::pair<std::list<std::string>, std::unordered_map<std::string, bool>> path_t;
 
 /* ------------------ Helper Functions ------------------------- */
 
+/* Seeds the calling thread's random number generator */
+void seedRandom(uint32_t seed);
+
 int randomNumber(int lower, int upper);
 
-std::string getFrontKey(const std::string& word);
+/* Keys of a word of any length (at least minWordLength(rule)) */
+word_key_t getFrontKey(std::string_view word, const overlap_rule_t& rule = overlap_rule_t());
+
+word_key_t getBackKey(std::string_view word, const overlap_rule_t& rule = overlap_rule_t());
+
+/*
+ * Builds the partitioned adjacency lists of a dictionary with every word unvisited.
+ * If find_back_path is true: next_list follows sequence back_key->front_key.
+ * If find_back_path is false: next_list follows sequence front_key->back_key.
+ */
+partition_t newPartition(const dictionary_t& dict, bool find_back_path);
+
+/* Moves a word to the visited part of its list */
+void visitWord(partition_t& partition, uint32_t id);
+
+/* Moves a word back to the unvisited part of its list */
+void unvisitWord(partition_t& partition, uint32_t id);
+
+/* Visits/unvisits every word of a path */
+void visitPath(partition_t& partition, const std::pmr::list<uint32_t>& path);
+void unvisitPath(partition_t& partition, const std::pmr::list<uint32_t>& path);
 
-std::string getBackKey(const std::string& word);
+inline size_t numLists(const partition_t& partition)
+{
+    return partition.free.size();
+}
 
-/* Returns a random word from a vector. Return empty string if it fails to find a word */
-std::string randomWordFromVector(const std::vector<std::string>& word_list,
-                                 std::unordered_map<std::string, bool>& visited);
+inline bool isVisited(const partition_t& partition, uint32_t id)
+{
+    uint32_t list = partition.list_of[id];
+    return partition.pos[id] >= partition.start[list] + partition.free[list];
+}
 
+/* Returns the ID of a random unvisited word in list, or -1 if every word is visited */
+int randomUnvisitedWord(const partition_t& partition, int list);
 
-std::string randomWordFromDictionary(dict_t& dict);
+
+/*
+ * Builds a sampler over every word in the dictionary (or only the words marked in allowed, if given).
+ * If find_back_path is true: a word's degree is the number of words that can precede it.
+ * If find_back_path is false: a word's degree is the number of words that can follow it.
+ */
+sampler_t newSampler(const dictionary_t& dict,
+                     bool find_back_path,
+                     SampleMode mode,
+                     const std::vector<bool>* allowed = nullptr);
+
+/* Returns the ID of a random word from the sampler in O(1) */
+uint32_t randomWordFromSampler(const sampler_t& sampler);
 
 
 /* ------------------ Random Path Generation ------------------------- */
 
 
 /*
- * Generates a new random path given a dictionary.
+ * The generators below allocate the returned path from "resource".
+ */
+
+/*
+ * Generates a new random path given a dictionary partition.
+ * The partition must be built for the same traversal direction.
  * If find_back_path is true: generated path will follow sequence back_key->front_key.
  * If find_back_path is false: generated path will follow sequence front_key->back_key.
  */
-path_t newRandomPath(dict_t& dict, bool find_back_path);
+path_t newRandomPath(partition_t& partition,
+                     const sampler_t& sampler,
+                     bool find_back_path,
+                     std::pmr::memory_resource* resource = std::pmr::get_default_resource());
 
 /*
- * Takes a dictionary and a path and generates a new path by
- * backtracking "remove_size" steps.
+ * Takes a dictionary partition and a path and generates a new path by
+ * backtracking "remove_size" steps. On a complete restart the start word is drawn from sampler.
  * If find_back_path is true: words are removed from front of path and 
  *  random traversal occurs backward from the new front.
  * If find_back_path is false: words are removed from the back of the path and
   * and random traversal occurs forward from the new back.
  */
-path_t generateRandomPath(dict_t& dict,
+path_t generateRandomPath(partition_t& partition,
+                          const sampler_t& sampler,
                           const path_t& path_data,
                           size_t remove_size,
-                          bool find_back_path);
+                          bool find_back_path,
+                          std::pmr::memory_resource* resource = std::pmr::get_default_resource());
 
 
 /* ------------------ Greedy Path Generation ------------------------- */
@@ -56,30 +432,45 @@ path_t generateRandomPath(dict_t& dict,
 
 /*  
  * (Helper Function).
- * Takes a dictionary and a path. Appends a greedy path to the given path.
+ * Takes a dictionary partition and a path. Appends a greedy path to the given path.
+ * Every word of the path must already be visited in the partition,
+ * appended words are visited as they are added.
  * If find_back_path is true: append from front and traverse backward.
  * If find_back_path is false: append from back and traverse forward.
  */
-void appendGreedyPath(dict_t& dict, path_t& path_data, bool find_back_path);
+void appendGreedyPath(partition_t& partition, path_t& path_data, bool find_back_path);
 
 
 /* Returns the greedy path of the dictionary */
-path_t newGreedyPath(dict_t& front_dict, dict_t& back_dict);
+path_t newGreedyPath(const dictionary_t& dict);
+
+
+/*
+ * Repairs a path found before its dictionary changed, so a search can be warm-started from it.
+ * Words no longer in the dictionary are dropped and each gap is spliced shut, directly if its
+ * ends still chain or through one or two unused bridge words. Where a gap cannot be closed the path is
+ * split, the longest piece is kept and extended greedily at both ends.
+ * Returns the repaired path of word IDs (empty if no word of the path is left).
+ */
+std::vector<uint32_t> repairPath(const dictionary_t& dict, const std::list<std::string>& path);
 
 
 /*
- * Takes a dictionary and a path and generates a new path by
+ * Takes a dictionary partition and a path and generates a new path by
  * backtracking "remove_size" steps. A random word is chosen for the next node in
  * the path (that matches the sequence constraint) and a greedy traversal is done from there.
+ * On a complete restart the start word is drawn from sampler.
  * If find_back_path is true: words are removed from front of path and 
  *  traversal occurs backward from the new front.
  * If find_back_path is false: words are removed from the back of the path and
  *  traversal occurs forward from the new back.
  */
-path_t generateGreedyRandomPath(dict_t& dict,
+path_t generateGreedyRandomPath(partition_t& partition,
+                                const sampler_t& sampler,
                                 const path_t& path_data,
                                 size_t remove_size,
-                                bool find_back_path);
+                                bool find_back_path,
+                                std::pmr::memory_resource* resource = std::pmr::get_default_resource());
 
                         
 
@@ -0,0 +1,101 @@
+#include "PerfCounters.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+/* ------------------ Hardware Performance Counters ------------------------- */
+
+
+std::string perfCounterName(int counter)
+{
+    switch (counter) {
+        case PerfCycles: return "cycles";
+        case PerfInstructions: return "instructions";
+        case PerfCacheMisses: return "cache_misses";
+        case PerfBranchMisses: return "branch_misses";
+        case PerfPageFaults: return "page_faults";
+    }
+    return "";
+}
+
+#ifdef __linux__
+
+/* Opens one counter of the calling thread, returns -1 on failure */
+static int openCounter(uint32_t type, uint64_t config)
+{
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1; // allowed without privileges (perf_event_paranoid <= 2).
+    attr.exclude_hv = 1;
+
+    return syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+perf_group_t openPerfCounters()
+{
+    perf_group_t group;
+    group.fds[PerfCycles] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    group.fds[PerfInstructions] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    group.fds[PerfCacheMisses] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+    group.fds[PerfBranchMisses] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+    group.fds[PerfPageFaults] = openCounter(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS);
+    return group;
+}
+
+void closePerfCounters(perf_group_t& group)
+{
+    for (int& fd : group.fds) {
+        if (fd >= 0) close(fd);
+        fd = -1;
+    }
+}
+
+void startPerfCounters(perf_group_t& group)
+{
+    for (int fd : group.fds) {
+        if (fd < 0) continue;
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+perf_counts_t stopPerfCounters(perf_group_t& group)
+{
+    perf_counts_t counts;
+    for (int i = 0; i < NumPerfCounters; i++) {
+        int fd = group.fds[i];
+        if (fd < 0) continue;
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        counts.available[i] = read(fd, &counts.values[i], sizeof(uint64_t)) == sizeof(uint64_t);
+    }
+    return counts;
+}
+
+#else
+
+perf_group_t openPerfCounters()
+{
+    perf_group_t group;
+    for (int& fd : group.fds) fd = -1;
+    return group;
+}
+
+void closePerfCounters(perf_group_t&) {}
+
+void startPerfCounters(perf_group_t&) {}
+
+perf_counts_t stopPerfCounters(perf_group_t&)
+{
+    return perf_counts_t();
+}
+
+#endif
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+/* ------------------ Hardware Performance Counters ------------------------- */
+
+/*
+ * Opt-in hardware performance counters (Linux perf_event_open) for timing solver phases.
+ * Counters count user space events of the calling thread only. A counter the kernel
+ * or CPU does not provide is reported as unavailable rather than failing the run.
+ */
+
+/* Counters recorded for each phase */
+enum PerfCounter { PerfCycles, PerfInstructions, PerfCacheMisses, PerfBranchMisses, PerfPageFaults, NumPerfCounters };
+
+/* Values of every counter over one phase. available[i] is false if counter i could not be opened */
+struct perf_counts_t {
+    uint64_t values[NumPerfCounters] = {};
+    bool available[NumPerfCounters] = {};
+};
+
+/* Open counter file descriptors of the calling thread (-1 if unavailable) */
+struct perf_group_t {
+    int fds[NumPerfCounters];
+};
+
+/* Column name of a counter (e.g. "cache_misses") */
+std::string perfCounterName(int counter);
+
+/* Opens every counter for the calling thread */
+perf_group_t openPerfCounters();
+
+void closePerfCounters(perf_group_t& group);
+
+/* Resets and starts every open counter */
+void startPerfCounters(perf_group_t& group);
+
+/* Stops every open counter and returns its values since startPerfCounters */
+perf_counts_t stopPerfCounters(perf_group_t& group);
@@ -0,0 +1,158 @@
+#include "Pipeline.h"
+#include "Dictionary.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <atomic>
+#include <chrono>
+
+/* Chrono clock */
+typedef std::chrono::steady_clock Clock;
+
+/* ------------------ Pipelined Sweeps ------------------------- */
+
+
+/* Runs every stage of each item on the solver threads, taking items in order */
+static bool runInline(size_t num_items,
+                      int num_solvers,
+                      const std::function<bool(size_t)>& load,
+                      const std::function<void(size_t)>& solve,
+                      const std::function<void(size_t)>& validate)
+{
+    std::atomic<size_t> next{0};
+    std::atomic<bool> failed{false};
+    auto worker = [&]() {
+        size_t i;
+        while ((i = next++) < num_items) {
+            if (!load(i)) {
+                failed = true;
+                continue;
+            }
+            solve(i);
+            validate(i);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (int t = 1; t < num_solvers; t++)
+        pool.emplace_back(worker);
+    worker();
+    for (auto& t : pool)
+        t.join();
+    return !failed;
+}
+
+bool runPipeline(size_t num_items,
+                 int num_solvers,
+                 size_t depth,
+                 const std::function<bool(size_t)>& load,
+                 const std::function<void(size_t)>& solve,
+                 const std::function<void(size_t)>& validate)
+{
+    num_solvers = std::max(1, std::min<int>(num_solvers, num_items));
+    if (depth == 0)
+        return runInline(num_items, num_solvers, load, solve, validate);
+
+    std::mutex mutex;
+    std::condition_variable producer_cv, solver_cv;
+    std::deque<size_t> loaded;     // bounded queue of items ready to solve (at most depth).
+    std::deque<size_t> solved;     // items waiting to be validated.
+    size_t next_load = 0;          // next item to load.
+    bool loads_done = false;       // every item has been loaded (or failed to).
+    size_t finished = 0;           // items validated, or dropped because their load failed.
+    bool failed = false;
+
+    // Producer: validates finished items first (so results complete promptly),
+    // otherwise loads the next item whenever the queue has room.
+    std::thread producer([&]() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (finished < num_items) {
+            producer_cv.wait(lock, [&]() {
+                return !solved.empty() || (next_load < num_items && loaded.size() < depth);
+            });
+
+            if (!solved.empty()) {
+                size_t i = solved.front();
+                solved.pop_front();
+                lock.unlock();
+                validate(i);
+                lock.lock();
+                finished++;
+                continue;
+            }
+
+            size_t i = next_load++;
+            lock.unlock();
+            bool ok = load(i);
+            lock.lock();
+            if (ok) {
+                loaded.push_back(i);
+            } else {
+                failed = true;
+                finished++;
+            }
+            loads_done = (next_load == num_items);
+            solver_cv.notify_all();
+        }
+    });
+
+    // Solvers: take the next loaded item, solve it and hand it back for validation.
+    auto worker = [&]() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            solver_cv.wait(lock, [&]() { return !loaded.empty() || loads_done; });
+            if (loaded.empty())
+                return; // everything is loaded and taken.
+
+            size_t i = loaded.front();
+            loaded.pop_front();
+            producer_cv.notify_one(); // room in the queue.
+            lock.unlock();
+            solve(i);
+            lock.lock();
+            solved.push_back(i);
+            producer_cv.notify_one();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (int t = 1; t < num_solvers; t++)
+        pool.emplace_back(worker);
+    worker();
+    for (auto& t : pool)
+        t.join();
+    producer.join();
+    return !failed;
+}
+
+
+std::vector<sweep_result_t> sweepWordLengths(const std::string& filepath,
+                                             const std::vector<int>& lengths,
+                                             size_t depth,
+                                             const std::function<std::list<std::string>(const dictionary_t&)>& solve)
+{
+    std::vector<sweep_result_t> results(lengths.size());
+    std::vector<dictionary_t> dicts(lengths.size());
+
+    auto loadStage = [&](size_t i) {
+        auto start = Clock::now();
+        results[i].word_len = lengths[i];
+        results[i].num_words = loadDictionary(filepath, dicts[i], lengths[i]);
+        results[i].load_sec = std::chrono::duration<double>(Clock::now() - start).count();
+        return results[i].num_words >= 0;
+    };
+    auto solveStage = [&](size_t i) {
+        auto start = Clock::now();
+        results[i].path = solve(dicts[i]);
+        results[i].search_sec = std::chrono::duration<double>(Clock::now() - start).count();
+        dicts[i] = dictionary_t(); // only the queued dictionaries are kept in memory.
+    };
+    auto validateStage = [&](size_t i) {
+        results[i].correct = testPath(results[i].path);
+    };
+
+    if (!runPipeline(lengths.size(), 1, depth, loadStage, solveStage, validateStage))
+        return {};
+    return results;
+}
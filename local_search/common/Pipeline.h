@@ -0,0 +1,47 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <list>
+#include <functional>
+#include "PathGeneration.h"
+
+/* ------------------ Pipelined Sweeps ------------------------- */
+
+/*
+ * A sweep over word lengths is run as a three stage pipeline so that reading and building a
+ * dictionary, and validating a result, happen off the search's critical path:
+ *   load(i)     on a producer thread, at most "depth" items ahead of the searches (bounded queue),
+ *   solve(i)    on the calling thread and num_solvers-1 helper threads, taking items in order,
+ *   validate(i) back on the producer thread, interleaved with loading (validation first).
+ * With depth 0 there is no producer, each solver thread runs load, solve and validate inline.
+ * Items whose load fails are neither solved nor validated.
+ * Returns false if any load failed.
+ */
+bool runPipeline(size_t num_items,
+                 int num_solvers,
+                 size_t depth,
+                 const std::function<bool(size_t)>& load,
+                 const std::function<void(size_t)>& solve,
+                 const std::function<void(size_t)>& validate);
+
+
+/* Result of one word length of a sweep */
+struct sweep_result_t {
+    int word_len = 0;
+    int num_words = 0;
+    double load_sec = 0;    // reading and building the dictionary.
+    double search_sec = 0;
+    std::list<std::string> path;
+    bool correct = false;
+};
+
+/*
+ * Solves every word length, in order, on the calling thread while a producer thread loads the
+ * next "depth" dictionaries from filepath and validates the paths found.
+ * Returns one result per length, or an empty vector if the dictionary cannot be read.
+ */
+std::vector<sweep_result_t> sweepWordLengths(const std::string& filepath,
+                                             const std::vector<int>& lengths,
+                                             size_t depth,
+                                             const std::function<std::list<std::string>(const dictionary_t&)>& solve);
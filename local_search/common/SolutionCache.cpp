@@ -0,0 +1,158 @@
+#include "SolutionCache.h"
+#include "Dictionary.h"
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <filesystem>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+
+/* ------------------ Solution Cache ------------------------- */
+
+/* First word of every solution file */
+static const char* solution_magic = "lpws-solution";
+
+
+/* 64 bit FNV-1a hash of a word, finished with a mixing step so the per word hashes can be summed */
+static uint64_t wordHash(std::string_view word)
+{
+    uint64_t h = 14695981039346656037ull;
+    for (char c : word) {
+        h ^= (uint8_t)c;
+        h *= 1099511628211ull;
+    }
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    return h;
+}
+
+uint64_t dictionaryHash(const dictionary_t& dict)
+{
+    uint64_t h = numWords(dict.words);
+    for (uint32_t id = 0; id < numWords(dict.words); id++)
+        h += wordHash(wordAt(dict.words, id));
+    return h;
+}
+
+solution_key_t solutionKey(const dictionary_t& dict)
+{
+    solution_key_t key;
+    key.dict_hash = dictionaryHash(dict);
+    key.word_len = dict.words.word_len;
+    key.rule = ruleName(dict.rule);
+    return key;
+}
+
+/* Header line of a solution file */
+static std::string solutionHeader(const solution_key_t& key)
+{
+    std::ostringstream ss;
+    ss << solution_magic << ' ' << std::hex << std::setw(16) << std::setfill('0') << key.dict_hash
+       << std::dec << ' ' << key.word_len << ' ' << key.rule;
+    return ss.str();
+}
+
+std::string solutionPath(const std::string& cache_dir, const solution_key_t& key)
+{
+    std::ostringstream ss;
+    ss << std::hex << std::setw(16) << std::setfill('0') << key.dict_hash
+       << std::dec << '-' << wordLengthName(key.word_len) << '-' << key.rule << ".txt";
+    return (std::filesystem::path(cache_dir) / ss.str()).string();
+}
+
+/*
+ * Converts a sequence of words to word IDs of dict.
+ * Returns false if a word is not in dict, is repeated or does not follow the previous word.
+ */
+template <typename Words>
+static bool sequenceIds(const dictionary_t& dict, const Words& words, std::vector<uint32_t>& ids)
+{
+    std::vector<bool> used(numWords(dict.words), false);
+    for (const auto& word : words) {
+        int id = findWord(dict, word);
+        if (id < 0 || used[id])
+            return false;
+        if (!ids.empty() && dict.back_keys[ids.back()] != dict.front_keys[id])
+            return false;
+        used[id] = true;
+        ids.push_back(id);
+    }
+    return true;
+}
+
+std::vector<uint32_t> loadSolution(const std::string& cache_dir, const dictionary_t& dict)
+{
+    solution_key_t key = solutionKey(dict);
+    std::string path = solutionPath(cache_dir, key);
+    std::ifstream infile(path);
+    if (infile.fail())
+        return {};
+
+    std::string header;
+    std::getline(infile, header);
+    std::vector<std::string> words;
+    std::string word;
+    while (infile >> word)
+        words.push_back(word);
+
+    std::vector<uint32_t> ids;
+    if (header != solutionHeader(key) || !sequenceIds(dict, words, ids)) {
+        std::cerr << "Ignoring stale solution: " << path << '\n';
+        return {};
+    }
+    return ids;
+}
+
+bool storeSolution(const std::string& cache_dir, const dictionary_t& dict, const std::list<std::string>& path)
+{
+    std::vector<uint32_t> ids;
+    if (path.empty() || !sequenceIds(dict, path, ids))
+        return false;
+    if (path.size() <= loadSolution(cache_dir, dict).size())
+        return false; // checked again under the lock before the entry is replaced.
+
+    solution_key_t key = solutionKey(dict);
+    std::string file = solutionPath(cache_dir, key);
+
+    // Write to a file of our own (randomly named), then rename it over the entry,
+    // so that readers and concurrent writers never see a partial file.
+    std::error_code ec;
+    std::filesystem::create_directories(cache_dir, ec);
+    std::ostringstream tmp;
+    tmp << file << '.' << std::hex << std::random_device{}() << ".tmp";
+    {
+        std::ofstream outfile(tmp.str());
+        if (outfile.fail()) {
+            std::cerr << "Cannot write solution: " << tmp.str() << '\n';
+            return false;
+        }
+        outfile << solutionHeader(key) << '\n';
+        for (const std::string& word : path)
+            outfile << word << '\n';
+        if (!outfile.good())
+            return false;
+    }
+
+    // Compare and rename under an advisory lock on the entry's lock file, so that of two
+    // concurrent writers the shorter path cannot replace the longer one.
+    int lock_fd = open((file + ".lock").c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (lock_fd < 0 || flock(lock_fd, LOCK_EX) != 0) {
+        std::cerr << "Cannot lock solution: " << file << '\n';
+        if (lock_fd >= 0) close(lock_fd);
+        std::filesystem::remove(tmp.str(), ec);
+        return false;
+    }
+    bool longer = path.size() > loadSolution(cache_dir, dict).size();
+    if (longer)
+        std::filesystem::rename(tmp.str(), file, ec);
+    close(lock_fd);
+
+    if (!longer || ec) {
+        if (ec) std::cerr << "Cannot write solution: " << file << '\n';
+        std::filesystem::remove(tmp.str(), ec);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <list>
+#include "PathGeneration.h"
+
+/* ------------------ Solution Cache ------------------------- */
+
+/*
+ * On-disk store of the longest sequence found so far, one file per
+ * (dictionary content hash, word length, overlap rule name) in a cache directory.
+ * Runs start from the stored path and store whatever beats it, so repeated runs only ever ratchet upward.
+ * A file holds a header line followed by the words of the path, one per line.
+ */
+
+/* Identifies the dictionary a solution belongs to */
+struct solution_key_t {
+    uint64_t dict_hash = 0;
+    int word_len = 0;
+    std::string rule;
+};
+
+/*
+ * Hash of the words of a dictionary. It does not depend on the order of the words,
+ * so reordering the word list keeps its solutions.
+ */
+uint64_t dictionaryHash(const dictionary_t& dict);
+
+/* Key of a dictionary, under its rule (see ruleName) */
+solution_key_t solutionKey(const dictionary_t& dict);
+
+/* File of a solution within the cache directory */
+std::string solutionPath(const std::string& cache_dir, const solution_key_t& key);
+
+/*
+ * Loads the stored solution of a dictionary as word IDs.
+ * An entry that does not match the dictionary (unknown or repeated words, broken sequence, wrong header)
+ * is stale, it is reported and ignored.
+ * Returns an empty path if there is no valid entry.
+ */
+std::vector<uint32_t> loadSolution(const std::string& cache_dir, const dictionary_t& dict);
+
+/*
+ * Stores path as the solution of a dictionary if it is a valid sequence longer than the stored one.
+ * The file is replaced atomically (written aside, then renamed), and the comparison with the stored
+ * path and the rename hold an advisory lock (flock on the entry's ".lock" file), so concurrent
+ * writers never replace a longer path with a shorter one.
+ * Returns true if the store was updated.
+ */
+bool storeSolution(const std::string& cache_dir, const dictionary_t& dict, const std::list<std::string>& path);
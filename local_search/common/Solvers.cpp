@@ -0,0 +1,1069 @@
+#include "Solvers.h"
+#include "Checkpoint.h"
+#include "TopK.h"
+#include "Constraints.h"
+#include "Kernel.h"
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+/* Chrono clock */
+typedef std::chrono::steady_clock Clock;
+
+/* ------------------ Parameters ------------------------- */
+
+
+bool parseAlgorithm(const std::string& name, Algorithm& algo)
+{
+    if (name == "dfs") algo = Algorithm::DFS;
+    else if (name == "greedy") algo = Algorithm::Greedy;
+    else if (name == "hill") algo = Algorithm::HillClimbing;
+    else if (name == "sa") algo = Algorithm::SimulatedAnnealing;
+    else if (name == "random-greedy") algo = Algorithm::RandomGreedy;
+    else if (name == "lns") algo = Algorithm::LargeNeighbourhood;
+    else return false;
+    return true;
+}
+
+std::string algorithmName(Algorithm algo)
+{
+    switch (algo) {
+        case Algorithm::DFS: return "dfs";
+        case Algorithm::Greedy: return "greedy";
+        case Algorithm::HillClimbing: return "hill";
+        case Algorithm::SimulatedAnnealing: return "sa";
+        case Algorithm::RandomGreedy: return "random-greedy";
+        case Algorithm::LargeNeighbourhood: return "lns";
+    }
+    return "";
+}
+
+bool kernelByDefault(Algorithm algo)
+{
+    return algo != Algorithm::SimulatedAnnealing;
+}
+
+/* Returns true if the engine started at start has used up its time limit */
+static bool timedOut(const Clock::time_point& start, const solve_params_t& params)
+{
+    if (params.time_limit <= 0)
+        return false;
+    return std::chrono::duration<double>(Clock::now() - start).count() >= params.time_limit;
+}
+
+
+/* Path arenas of the calling thread, reused by every local search run on it */
+static thread_local path_arena_t path_arena;
+
+
+/* Records that the longest path found has grown to length */
+static void recordTrace(solve_stats_t* stats, const Clock::time_point& start, size_t length)
+{
+    if (stats)
+        stats->trace.emplace_back(std::chrono::duration<double>(Clock::now() - start).count(), length);
+}
+
+
+/* ------------------ Depth-First-Search ------------------------- */
+
+
+void appendSequence(std::vector<uint32_t>& s,
+                    uint32_t start_word,
+                    const std::vector<bool>& visited,
+                    const dictionary_t& dict,
+                    bool backward)
+{
+    const dict_t& lists = (backward) ? dict.back : dict.front;
+    int row = (backward) ? dict.prev_row[start_word] : dict.next_row[start_word];
+    if (row < 0)
+        return;
+
+    for (uint32_t i = lists.start[row]; i < lists.start[row+1]; i++) {
+        uint32_t next_word = lists.ids[i];
+        if (!visited[next_word]) {
+            // If there does not exist a sequence after next_word,
+            // the backtrack marker will trigger a backtrack when popped.
+            s.push_back(DFSBacktrack);
+            s.push_back(next_word);
+        }
+    }
+}
+
+bool searchesBackward(const path_constraints_t* constraints)
+{
+    return constraints && constraints->start < 0 && constraints->end >= 0;
+}
+
+dfs_state_t newDFSState(const dictionary_t& dict, const path_constraints_t* constraints)
+{
+    size_t num_words = numWords(dict.words);
+    dfs_state_t state;
+    state.visited.resize(num_words);
+
+    if (constraints) {
+        // Words that cannot appear are visited from the start, the search starts at the anchored word.
+        bool backward = searchesBackward(constraints);
+        constraint_masks_t masks = newConstraintMasks(dict, *constraints, backward);
+        int anchor = (backward) ? constraints->end : constraints->start;
+        for (uint32_t id = 0; id < num_words; id++) {
+            state.visited[id] = !masks.allowed[id];
+            if (masks.allowed[id] && (anchor < 0 || (int)id == anchor)) {
+                state.stack.push_back(DFSBacktrack);
+                state.stack.push_back(id);
+            }
+        }
+        state.root_base = state.stack.size();
+        return state;
+    }
+
+    // Add all nodes to initial level of DFS.
+    for (uint32_t id = 0; id < num_words; id++) {
+        state.stack.push_back(DFSBacktrack);
+        state.stack.push_back(id);
+    }
+    state.root_base = state.stack.size();
+    return state;
+}
+
+/*
+ * Required words held by the current path of a constrained DFS, updated as words are pushed and
+ * popped, so that the search can tell in O(required) whether a path is complete or can be extended.
+ */
+struct dfs_constraints_t {
+    const path_constraints_t* constraints = nullptr;
+    constraint_masks_t masks;
+    std::vector<bool> held;
+    size_t num_held = 0;
+    int closing = -1;   // the word the path must end with in the traversal direction, or -1.
+};
+
+static dfs_constraints_t newDFSConstraints(const dictionary_t& dict,
+                                           const path_constraints_t* constraints,
+                                           const std::vector<uint32_t>& current_path)
+{
+    dfs_constraints_t dc;
+    dc.constraints = constraints;
+    if (!constraints)
+        return dc;
+
+    bool backward = searchesBackward(constraints);
+    dc.masks = newConstraintMasks(dict, *constraints, backward);
+    dc.held.resize(constraints->required.size());
+    dc.closing = (backward) ? -1 : constraints->end;
+    for (uint32_t id : current_path) {
+        int r = dc.masks.required_index[id];
+        if (r >= 0) { dc.held[r] = true; dc.num_held++; }
+    }
+    return dc;
+}
+
+/* Records that word joined (or, if leaving, left) the current path */
+static void holdWord(dfs_constraints_t& dc, uint32_t word, bool leaving)
+{
+    int r = dc.masks.required_index[word];
+    if (r < 0)
+        return;
+    dc.held[r] = !leaving;
+    if (leaving) dc.num_held--;
+    else dc.num_held++;
+}
+
+/* True if the current path, ending at word, meets the constraints */
+static bool pathComplete(const dfs_constraints_t& dc, uint32_t word)
+{
+    return dc.num_held == dc.held.size() && (dc.closing < 0 || (int)word == dc.closing);
+}
+
+/* True if the current path may grow past word: it is not the closing word and can still reach every required word it lacks */
+static bool pathExtendable(const dfs_constraints_t& dc, uint32_t word)
+{
+    if ((int)word == dc.closing)
+        return false;
+    for (size_t r = 0; r < dc.held.size(); r++) {
+        if (!dc.held[r] && !dc.masks.reaches[r][word])
+            return false;
+    }
+    return true;
+}
+
+void runDFS(const dictionary_t& dict,
+            dfs_state_t& state,
+            const solve_params_t& params,
+            solve_stats_t* stats)
+{
+    auto start = Clock::now();
+    auto last_checkpoint = start;
+    bool checkpointing = !params.checkpoint_path.empty();
+    bool backward = searchesBackward(params.constraints);
+    auto& s = state.stack;
+    auto& current_path = state.current_path;
+    dfs_constraints_t dc = newDFSConstraints(dict, params.constraints, current_path);
+    state.exact = params.exact; // saved with the state, see loadDFSState.
+
+    // Paths are compared by the words they stand for (their length, unless dict is a kernel).
+    size_t current_weight = pathWeight(dict, current_path);
+    size_t max_weight = pathWeight(dict, state.max_path);
+    recordTrace(stats, start, max_weight);
+
+    // Run DFS
+    size_t iterations = 0;
+    while (!s.empty())
+    {
+        // Checking the clock is cheap relative to an expansion, but not free.
+        if ((iterations + 1) % 1024 == 0) {
+            if (timedOut(start, params))
+                break;
+            if (checkpointing && std::chrono::duration<double>(Clock::now() - last_checkpoint).count()
+                                 >= params.checkpoint_interval) {
+                state.iterations += iterations;
+                iterations = 0;
+                saveDFSState(params.checkpoint_path, dict, state);
+                last_checkpoint = Clock::now();
+            }
+        }
+
+        iterations++;
+        uint32_t word = s.back();
+        s.pop_back();
+
+        if (word == DFSBacktrack) {
+            // If no words were added to the stack on the previous iteration
+            // then backtrack.
+            if (dc.constraints)
+                holdWord(dc, current_path.back(), true);
+            if (params.exact)
+                state.visited[current_path.back()] = false; // free for the other branches.
+            current_weight -= wordWeight(dict, current_path.back());
+            current_path.pop_back();
+            if (current_path.empty())
+                state.root_base = s.size(); // finished a root.
+        } else {
+            // Otherwise add the word to the current path
+            // and branch from there.
+            if (current_path.empty())
+                state.root_base = s.size() - 1; // starting a root, its marker is on top.
+            current_path.push_back(word);
+            current_weight += wordWeight(dict, word);
+            state.visited[word] = true;
+
+            bool complete = true;
+            bool extendable = true;
+            if (dc.constraints) {
+                holdWord(dc, word, false);
+                complete = pathComplete(dc, word);
+                extendable = pathExtendable(dc, word);
+            }
+
+            // Update current path if we have expanded further than the current max.
+            if (complete && current_weight > max_weight) {
+                state.max_path = current_path;
+                max_weight = current_weight;
+                recordTrace(stats, start, max_weight);
+            }
+
+            // Expand DFS. A path that cannot be extended is a candidate sequence.
+            size_t stack_size = s.size();
+            if (extendable)
+                appendSequence(s, word, state.visited, dict, backward);
+            if (params.top && complete && s.size() == stack_size) {
+                if (backward)
+                    offerPath(*params.top, std::vector<uint32_t>(current_path.rbegin(), current_path.rend()));
+                else
+                    offerPath(*params.top, current_path);
+            }
+        }
+    }
+
+    state.iterations += iterations;
+    if (checkpointing)
+        saveDFSState(params.checkpoint_path, dict, state);
+    if (stats) stats->iterations = state.iterations;
+}
+
+std::vector<uint32_t> dfs(const dictionary_t& dict,
+                          const solve_params_t& params,
+                          solve_stats_t* stats)
+{
+    dfs_state_t state;
+    if (!params.resume || !loadDFSState(params.checkpoint_path, dict, params.exact, state))
+        state = newDFSState(dict, params.constraints);
+
+    runDFS(dict, state, params, stats);
+    if (searchesBackward(params.constraints))
+        std::reverse(state.max_path.begin(), state.max_path.end());
+    return state.max_path;
+}
+
+
+/* ------------------ Local Search Moves ------------------------- */
+
+
+/*
+ * Partitioned adjacency lists for each traversal direction, and samplers used to pick start words
+ * on complete restarts, shared by the moves of a local search. With constraints, words that cannot
+ * appear are visited for good, restarts start at the anchored word (else at a required word), and
+ * only the direction growing away from an anchor is searched.
+ */
+struct local_search_t {
+    partition_t front_partition;
+    partition_t back_partition;
+    sampler_t front_sampler;
+    sampler_t back_sampler;
+    const path_constraints_t* constraints = nullptr;
+    bool forward = true;
+    bool backward = true;
+};
+
+static local_search_t newLocalSearch(const dictionary_t& dict, const solve_params_t& params)
+{
+    local_search_t search;
+    search.front_partition = newPartition(dict, false);
+    search.back_partition = newPartition(dict, true);
+    search.constraints = params.constraints;
+    if (!params.constraints) {
+        search.front_sampler = newSampler(dict, false, params.sample_mode);
+        search.back_sampler = newSampler(dict, true, params.sample_mode);
+        return search;
+    }
+
+    const path_constraints_t& c = *params.constraints;
+    constraint_masks_t masks = newConstraintMasks(dict, c, false);
+    for (uint32_t id = 0; id < masks.allowed.size(); id++) {
+        if (!masks.allowed[id]) {
+            visitWord(search.front_partition, id);
+            visitWord(search.back_partition, id);
+        }
+    }
+
+    std::vector<bool> starts = masks.allowed;
+    if (c.start >= 0 || c.end >= 0 || !c.required.empty()) {
+        starts.assign(starts.size(), false);
+        if (c.start >= 0) starts[c.start] = true;
+        else if (c.end >= 0) starts[c.end] = true;
+        else for (uint32_t id : c.required) starts[id] = true;
+    }
+    search.front_sampler = newSampler(dict, false, params.sample_mode, &starts);
+    search.back_sampler = newSampler(dict, true, params.sample_mode, &starts);
+    search.forward = c.start >= 0 || c.end < 0;
+    search.backward = c.start < 0;
+    return search;
+}
+
+/*
+ * Cuts a candidate after the end word (a search anchored at both ends grows forward past it)
+ * and returns true if it then meets the constraints. Candidates never hold words that cannot appear.
+ */
+static bool fitConstraints(const path_constraints_t& c, path_t& p)
+{
+    auto& path = p.first;
+    if (c.start >= 0 && c.end >= 0) {
+        auto it = std::find(path.begin(), path.end(), (uint32_t)c.end);
+        if (it == path.end())
+            return false;
+        for (auto cut = std::next(it); cut != path.end(); ++cut)
+            p.second.erase(*cut);
+        path.erase(std::next(it), path.end());
+    }
+
+    if (path.empty())
+        return false;
+    if (c.start >= 0 && path.front() != (uint32_t)c.start)
+        return false;
+    if (c.end >= 0 && path.back() != (uint32_t)c.end)
+        return false;
+    for (uint32_t id : c.required) {
+        if (p.second.find(id) == p.second.end())
+            return false;
+    }
+    return true;
+}
+
+/*
+ * One local search move: generates a new path from path by backtracking remove_size steps
+ * (see generateGreedyRandomPath), alternating traversal direction randomly (coin toss) when
+ * both directions are searched. With constraints, a candidate that does not meet them comes back empty.
+ */
+static path_t generateCandidate(local_search_t& search,
+                                const path_t& path,
+                                size_t remove_size,
+                                std::pmr::memory_resource* resource)
+{
+    bool forward = (search.forward && search.backward) ? randomNumber(0, 1) : search.forward;
+    path_t new_path = (forward)
+        ? generateGreedyRandomPath(search.front_partition, search.front_sampler, path, remove_size, false, resource)
+        : generateGreedyRandomPath(search.back_partition, search.back_sampler, path, remove_size, true, resource);
+
+    if (search.constraints && !fitConstraints(*search.constraints, new_path)) {
+        new_path.first.clear();
+        new_path.second.clear();
+    }
+    return new_path;
+}
+
+
+/* ------------------ Greedy ------------------------- */
+
+
+std::list<std::string> solveGreedy(const dictionary_t& dict, const solve_params_t& params)
+{
+    if (!params.constraints)
+        return pathWords(dict.words, newGreedyPath(dict).first);
+
+    // A greedy path grown from a restart word (see local_search_t).
+    local_search_t search = newLocalSearch(dict, params);
+    return pathWords(dict.words, generateCandidate(search, path_t(), 0, std::pmr::get_default_resource()).first);
+}
+
+
+/* ------------------ Local Search ------------------------- */
+
+
+/*
+ * Path a local search starts from: the warm start path if given, otherwise the greedy path.
+ * With constraints, a warm start path that does not meet them is replaced by a greedy path
+ * grown from a restart word, which is empty if that does not meet them either.
+ */
+static path_t initialPath(const dictionary_t& dict, const solve_params_t& params, local_search_t& search)
+{
+    path_t path_data;
+    for (uint32_t id : params.initial_path) {
+        path_data.first.push_back(id);
+        path_data.second[id] = true;
+    }
+
+    if (search.constraints) {
+        if (!meetsConstraints(*search.constraints, path_data.first))
+            path_data = generateCandidate(search, path_t(), 0, std::pmr::get_default_resource());
+        return path_data;
+    }
+    if (params.initial_path.empty())
+        return newGreedyPath(dict);
+    return path_data;
+}
+
+
+std::list<std::string> solveHillClimbing(const dictionary_t& dict,
+                                         const solve_params_t& params,
+                                         solve_stats_t* stats)
+{
+    auto start = Clock::now();
+
+    // Partitioned adjacency lists and restart samplers (see local_search_t).
+    local_search_t search = newLocalSearch(dict, params);
+
+    // Initial (greedy or warm start) path. Later paths are built in the thread's path arenas.
+    std::optional<path_t> current_path(initialPath(dict, params, search));
+    int current_length = pathWeight(dict, current_path->first);
+
+    recordTrace(stats, start, current_length);
+
+    // Loop until we cannot find a longer path for max consecutive attempts.
+    size_t attempt = 0;
+    size_t iterations = 0;
+    while (attempt <= params.max_attempts)
+    {
+        // For each position in the current path.
+        for (int i = 0; i <= (int)current_path->first.size(); i++) {
+            if (timedOut(start, params)) {
+                if (stats) stats->iterations = iterations;
+                return pathWords(dict.words, current_path->first);
+            }
+            std::pmr::memory_resource* scratch = scratchArena(path_arena);
+
+            // Generate new path from current path by backtracking i steps.
+            path_t new_path = generateCandidate(search, *current_path, i, scratch);
+            iterations++;
+            if (params.top)
+                offerPath(*params.top, new_path.first);
+
+            int new_path_length = pathWeight(dict, new_path.first);
+            if (new_path_length > current_length) {
+                // Update current path.
+                current_path.emplace(std::move(new_path));
+                keepScratch(path_arena);
+                current_length = new_path_length;
+                attempt = 0;
+                recordTrace(stats, start, current_length);
+            } else {
+                if (params.verbose && attempt % 100 == 0 && attempt != 0) {
+                    std::cout << attempt << std::endl;
+                }
+                attempt++; // failed to find better path.
+            }
+
+        }
+        if (params.verbose)
+            std::cout << "Found." << std::endl;
+
+    }
+
+    if (stats) stats->iterations = iterations;
+    return pathWords(dict.words, current_path->first);
+}
+
+std::list<std::string> solveSimulatedAnnealing(const dictionary_t& dict,
+                                               const solve_params_t& params,
+                                               solve_stats_t* stats)
+{
+    auto start = Clock::now();
+    double temperature = params.temperature;
+
+    // Partitioned adjacency lists and restart samplers (see local_search_t).
+    local_search_t search = newLocalSearch(dict, params);
+
+    // Initial (greedy or warm start) path. Later paths are built in the thread's path arenas.
+    std::optional<path_t> current_path(initialPath(dict, params, search));
+    int current_length = pathWeight(dict, current_path->first);
+
+    // Longest path seen so far (the current path may get shorter).
+    int best_length = current_length;
+    recordTrace(stats, start, best_length);
+
+    // Loop until we our temperature falls below 1.
+    size_t iterations = 0;
+    while (temperature > 1 && !timedOut(start, params))
+    {
+        temperature *= params.cooling_factor;
+
+        std::pmr::memory_resource* scratch = scratchArena(path_arena);
+
+        size_t backup_size = current_path->first.size()/2; // Backup 50%
+
+        if (randomNumber(0, 10) == 1)
+            backup_size = current_path->first.size(); // 10% chance of a complete random restart
+
+        // Generate new path from current path.
+        path_t new_path = generateCandidate(search, *current_path, backup_size, scratch);
+        iterations++;
+        if (params.top)
+            offerPath(*params.top, new_path.first);
+
+        // A candidate breaking the constraints is never accepted.
+        if (new_path.first.empty())
+            continue;
+
+        int new_path_length = pathWeight(dict, new_path.first);
+        double delta = current_length - new_path_length;
+
+        if (delta < 0) {
+            // Update current path.
+            current_path.emplace(std::move(new_path));
+            keepScratch(path_arena);
+            current_length = new_path_length;
+            if (current_length > best_length) {
+                best_length = current_length;
+                recordTrace(stats, start, best_length);
+            }
+        } else {
+            // Otherwise accept the new path based on a probability
+            double p = exp(-delta / temperature);
+            if (((double)randomNumber(1, 100)) / 100.0 < p) {
+                current_path.emplace(std::move(new_path));
+                keepScratch(path_arena);
+                current_length = new_path_length;
+            }
+        }
+        if (params.verbose)
+            std::cout << "temperature: " << temperature << '\n';
+    }
+
+    if (params.verbose)
+        std::cout << "Found." << '\n';
+
+    if (stats) stats->iterations = iterations;
+    return pathWords(dict.words, current_path->first);
+}
+
+std::list<std::string> solveRandomGreedy(const dictionary_t& dict,
+                                         const solve_params_t& params,
+                                         solve_stats_t* stats)
+{
+    auto start = Clock::now();
+
+    // Partitioned adjacency lists and restart samplers (see local_search_t).
+    local_search_t search = newLocalSearch(dict, params);
+
+    // Initial (greedy or warm start) path. Later paths are built in the thread's path arenas.
+    std::optional<path_t> max_path(initialPath(dict, params, search));
+    int max_length = pathWeight(dict, max_path->first);
+
+    recordTrace(stats, start, max_length);
+
+    // Loop until we cannot find a longer path, after trying for max consecutive attempts.
+    size_t attempt = 0;
+    size_t iterations = 0;
+    while (attempt < params.max_attempts && !timedOut(start, params))
+    {
+        std::pmr::memory_resource* scratch = scratchArena(path_arena);
+
+        // Choose a random backtrack length OR every 10th failed attempt restart.
+        int backtrack;
+        int max_size = max_path->first.size();
+        if (attempt % 10 == 0 || max_size < 2)
+            backtrack = max_size; // when backtrack equals path length, path generator does complete restart.
+        else
+            backtrack = randomNumber(1, max_size-1);
+
+        // Generate new path from max path.
+        path_t new_path = generateCandidate(search, *max_path, backtrack, scratch);
+        iterations++;
+        if (params.top)
+            offerPath(*params.top, new_path.first);
+
+        int new_path_length = pathWeight(dict, new_path.first);
+
+        if (new_path_length > max_length) {
+            // Update max path.
+            max_path.emplace(std::move(new_path));
+            keepScratch(path_arena);
+            max_length = new_path_length;
+            attempt = 0;
+            recordTrace(stats, start, max_length);
+        } else {
+            if (params.verbose && attempt % 100 == 0 && attempt != 0)
+                std::cout << "attempt: " << attempt << '\n';
+            attempt++;
+        }
+    }
+
+    if (params.verbose)
+        std::cout << "Found." << std::endl;
+
+    if (stats) stats->iterations = iterations;
+    return pathWords(dict.words, max_path->first);
+}
+
+
+/* ------------------ Large Neighbourhood Search ------------------------- */
+
+
+/* Longest window of the path a repair destroys */
+static const int LNSMaxWindow = 16;
+
+/* Most words a gap may be refilled with: twice its window, plus two */
+static const int LNSMaxGap = 2 * LNSMaxWindow + 2;
+
+/*
+ * Words the distance search of a repair may reach, and DFS expansions it may spend,
+ * past which it keeps the longest gap found so far
+ */
+static const size_t LNSRepairBudget = 1 << 12;
+
+/* Repairs each worker tries per round, between merges */
+static const int LNSRepairsPerRound = 64;
+
+/*
+ * One large neighbourhood search worker. Each round it repairs windows of its stripe of the path
+ * (a copy of path[begin, end)) against the words in use when the round started.
+ * size_score[k]: recent success rate of windows of k words, the weight window sizes are drawn with.
+ * Per repair scratch, indexed by word ID and valid where its stamp is the current repair's:
+ *   dist[id]: fewest words from word ID to the end of the gap (0: it can precede the word after the gap),
+ *   freed: word ID is in the window (free again), in_gap: word ID is in the gap being built.
+ * taken[id] == round: the stripe took word ID from the unused words this round.
+ */
+struct lns_worker_t {
+    std::mt19937 rng;
+    std::vector<double> size_score;
+    std::vector<uint32_t> stamp, freed;
+    std::vector<uint8_t> dist;
+    std::vector<bool> in_gap;
+    std::vector<uint32_t> taken;
+    std::vector<uint32_t> queue, gap, best_gap;
+    uint32_t repair = 0;
+    size_t begin = 0, end = 0;
+    std::vector<uint32_t> segment;
+    size_t attempts = 0, improvements = 0;
+
+    // The repair in progress.
+    int max_gap = 0;
+    size_t best_weight = 0, expansions = 0;
+};
+
+/* Words every worker reads during a round */
+struct lns_shared_t {
+    const dictionary_t& dict;
+    std::vector<bool> used;                 // on the path when the round started.
+    std::vector<bool> allowed;              // may appear at all (constraints).
+    std::vector<bool> required;             // may not be destroyed (constraints).
+    size_t max_weight = 1;                  // of any word, bounds what a gap can still gain.
+    uint32_t round = 0;
+};
+
+static lns_worker_t newLNSWorker(size_t num_words, uint32_t seed)
+{
+    lns_worker_t w;
+    w.rng.seed(seed);
+    w.size_score.assign(LNSMaxWindow + 1, 0.5);
+    w.stamp.assign(num_words, 0);
+    w.freed.assign(num_words, 0);
+    w.dist.assign(num_words, 0);
+    w.in_gap.assign(num_words, false);
+    w.taken.assign(num_words, 0);
+    return w;
+}
+
+/* True if word ID may be put in the gap of the worker's current repair */
+static bool gapFree(const lns_shared_t& shared, const lns_worker_t& w, uint32_t id)
+{
+    if (!shared.allowed[id] || w.in_gap[id])
+        return false;
+    return w.freed[id] == w.repair || (!shared.used[id] && w.taken[id] != shared.round);
+}
+
+/* Tries every extension of the gap after word "last" (of gap weight "weight"), keeping the heaviest complete one */
+static void extendGap(const lns_shared_t& shared, lns_worker_t& w, uint32_t last, size_t weight)
+{
+    int depth = w.gap.size();
+    if (depth > 0 && w.dist[last] == 0 && weight > w.best_weight) {
+        w.best_weight = weight;
+        w.best_gap = w.gap;
+    }
+    if (depth == w.max_gap || weight + (w.max_gap - depth) * shared.max_weight <= w.best_weight)
+        return;
+
+    int row = shared.dict.next_row[last];
+    if (row < 0)
+        return;
+    for (uint32_t i = shared.dict.front.start[row]; i < shared.dict.front.start[row+1]; i++) {
+        uint32_t id = shared.dict.front.ids[i];
+        // Only words that can still reach the end of the gap within the words left.
+        if (w.stamp[id] != w.repair || w.dist[id] >= w.max_gap - depth || !gapFree(shared, w, id))
+            continue;
+        if (++w.expansions > LNSRepairBudget)
+            return;
+        w.in_gap[id] = true;
+        w.gap.push_back(id);
+        extendGap(shared, w, id, weight + wordWeight(shared.dict, id));
+        w.gap.pop_back();
+        w.in_gap[id] = false;
+    }
+}
+
+/*
+ * Destroys segment[i, j] and refills the gap between segment[i-1] and segment[j+1] with the heaviest
+ * trail of free words (the window's and the unused ones) of at most 2(j-i+1)+2 words, found by a DFS
+ * bounded by LNSRepairBudget. Returns true if the gap is heavier than the window (and replaces it).
+ */
+static bool repairWindow(const lns_shared_t& shared, lns_worker_t& w, size_t i, size_t j)
+{
+    const dictionary_t& dict = shared.dict;
+    std::vector<uint32_t>& segment = w.segment;
+    w.repair++;
+    w.best_weight = 0;
+    for (size_t k = i; k <= j; k++) {
+        w.freed[segment[k]] = w.repair;
+        w.best_weight += wordWeight(dict, segment[k]);
+    }
+    w.max_gap = std::min<int>(2 * (j - i + 1) + 2, LNSMaxGap);
+    w.expansions = 0;
+    w.best_gap.clear();
+
+    // Distances to the end of the gap: a breadth first search backward from the word after it.
+    w.queue.clear();
+    int row = dict.prev_row[segment[j+1]];
+    if (row < 0)
+        return false;
+    for (uint32_t k = dict.back.start[row]; k < dict.back.start[row+1]; k++) {
+        uint32_t id = dict.back.ids[k];
+        if (gapFree(shared, w, id)) {
+            w.stamp[id] = w.repair;
+            w.dist[id] = 0;
+            w.queue.push_back(id);
+        }
+    }
+    for (size_t head = 0; head < w.queue.size() && w.queue.size() < LNSRepairBudget; head++) {
+        uint32_t id = w.queue[head];
+        if (w.dist[id] + 1 >= w.max_gap || (row = dict.prev_row[id]) < 0)
+            continue;
+        for (uint32_t k = dict.back.start[row]; k < dict.back.start[row+1]; k++) {
+            uint32_t prev = dict.back.ids[k];
+            if (w.stamp[prev] != w.repair && gapFree(shared, w, prev)) {
+                w.stamp[prev] = w.repair;
+                w.dist[prev] = w.dist[id] + 1;
+                w.queue.push_back(prev);
+            }
+        }
+    }
+
+    extendGap(shared, w, segment[i-1], 0);
+    if (w.best_gap.empty())
+        return false;
+
+    for (uint32_t id : w.best_gap) {
+        if (!shared.used[id])
+            w.taken[id] = shared.round;
+    }
+    segment.erase(segment.begin() + i, segment.begin() + j + 1);
+    segment.insert(segment.begin() + i, w.best_gap.begin(), w.best_gap.end());
+    return true;
+}
+
+/*
+ * Threads that run workers 1.. of a large neighbourhood search round after round (worker 0 runs on the caller).
+ * The caller starts a round by bumping round with the number of stripes to repair, then waits until
+ * pending (the stripes still being repaired on the threads) is back to 0.
+ */
+struct lns_pool_t {
+    std::mutex mutex;
+    std::condition_variable start_cv, done_cv;
+    uint32_t round = 0;
+    size_t num_stripes = 0;
+    size_t pending = 0;
+    bool stopping = false;
+    std::vector<std::thread> threads;
+};
+
+/* Draws a window size from the sizes that fit between the ends of a segment of len words */
+static int drawWindowSize(lns_worker_t& w, size_t len)
+{
+    int max_size = std::min<int>(LNSMaxWindow, len - 2);
+    double total = 0;
+    for (int k = 1; k <= max_size; k++)
+        total += w.size_score[k];
+    double x = std::uniform_real_distribution<double>(0, total)(w.rng);
+    for (int k = 1; k < max_size; k++) {
+        if ((x -= w.size_score[k]) < 0)
+            return k;
+    }
+    return max_size;
+}
+
+/* One round of a worker: LNSRepairsPerRound repairs of random windows of its segment */
+static void runLNSWorker(const lns_shared_t& shared, lns_worker_t& w)
+{
+    w.attempts = w.improvements = 0;
+    for (int r = 0; r < LNSRepairsPerRound && w.segment.size() >= 3; r++) {
+        int k = drawWindowSize(w, w.segment.size());
+        size_t i = std::uniform_int_distribution<size_t>(1, w.segment.size() - 1 - k)(w.rng);
+        size_t j = i + k - 1;
+        w.attempts++;
+
+        // Required words stay where they are.
+        bool fixed = false;
+        for (size_t m = i; m <= j && !fixed; m++)
+            fixed = shared.required[w.segment[m]];
+        bool improved = !fixed && repairWindow(shared, w, i, j);
+
+        // Window sizes that keep paying off are drawn more often.
+        w.size_score[k] = std::max(0.01, 0.9 * w.size_score[k] + 0.1 * improved);
+        w.improvements += improved;
+    }
+}
+
+/* Body of pool thread "index": repairs stripe index of every round that has one, until the pool stops */
+static void runLNSPoolThread(lns_pool_t& pool, const lns_shared_t& shared, lns_worker_t& w, size_t index)
+{
+    uint32_t seen = 0;
+    std::unique_lock<std::mutex> lock(pool.mutex);
+    while (true) {
+        pool.start_cv.wait(lock, [&]() { return pool.stopping || pool.round != seen; });
+        if (pool.stopping)
+            return;
+        seen = pool.round;
+        if (index >= pool.num_stripes)
+            continue; // the path is too short for this stripe.
+
+        lock.unlock();
+        runLNSWorker(shared, w);
+        lock.lock();
+        if (--pool.pending == 0)
+            pool.done_cv.notify_one();
+    }
+}
+
+/* Repairs the first num_stripes stripes at once, the first on the calling thread */
+static void runLNSRound(lns_pool_t& pool, const lns_shared_t& shared, std::vector<lns_worker_t>& workers,
+                        size_t num_stripes)
+{
+    {
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        pool.round++;
+        pool.num_stripes = num_stripes;
+        pool.pending = num_stripes - 1;
+    }
+    pool.start_cv.notify_all();
+    runLNSWorker(shared, workers[0]);
+
+    std::unique_lock<std::mutex> lock(pool.mutex);
+    pool.done_cv.wait(lock, [&]() { return pool.pending == 0; });
+}
+
+std::list<std::string> solveLargeNeighbourhood(const dictionary_t& dict,
+                                               const solve_params_t& params,
+                                               solve_stats_t* stats)
+{
+    auto start = Clock::now();
+    size_t num_words = numWords(dict.words);
+
+    // Initial (greedy or warm start) path, meeting the constraints if there are any.
+    local_search_t search = newLocalSearch(dict, params);
+    path_t initial = initialPath(dict, params, search);
+    std::vector<uint32_t> path(initial.first.begin(), initial.first.end());
+    size_t max_length = pathWeight(dict, path);
+    recordTrace(stats, start, max_length);
+
+    lns_shared_t shared{dict,
+                        std::vector<bool>(num_words, false),
+                        std::vector<bool>(num_words, true),
+                        std::vector<bool>(num_words, false)};
+    for (uint32_t id : path)
+        shared.used[id] = true;
+    if (params.constraints) {
+        shared.allowed = newConstraintMasks(dict, *params.constraints, false).allowed;
+        for (uint32_t id : params.constraints->required)
+            shared.required[id] = true;
+    }
+    if (!dict.weights.empty())
+        shared.max_weight = *std::max_element(dict.weights.begin(), dict.weights.end());
+
+    std::vector<lns_worker_t> workers;
+    for (int t = 0; t < std::max(1, params.workers); t++)
+        workers.push_back(newLNSWorker(num_words, randomNumber(0, INT32_MAX)));
+    std::vector<uint32_t> claimed(num_words, 0);
+
+    // Workers 1.. run on threads kept for the whole search.
+    lns_pool_t pool;
+    for (size_t t = 1; t < workers.size(); t++)
+        pool.threads.emplace_back(runLNSPoolThread, std::ref(pool), std::cref(shared), std::ref(workers[t]), t);
+    size_t min_stripe = (params.min_stripe) ? std::max<size_t>(params.min_stripe, 3) : LNSMaxWindow + 2;
+
+    // Each round the workers repair disjoint stripes of the path at once, then the stripes are merged.
+    size_t attempt = 0;
+    size_t iterations = 0;
+    while (attempt < params.max_attempts && !timedOut(start, params) && path.size() >= 3)
+    {
+        shared.round++;
+
+        // Stripes of at least min_stripe words, starting at a random offset so that
+        // the stripe boundaries move between rounds.
+        size_t num_stripes = std::clamp<size_t>(path.size() / min_stripe, 1, workers.size());
+        size_t stripe_len = path.size() / num_stripes;
+        size_t offset = (num_stripes > 1) ? randomNumber(0, stripe_len - 1) : 0;
+        for (size_t s = 0; s < num_stripes; s++) {
+            lns_worker_t& w = workers[s];
+            w.begin = std::min(path.size(), offset + s * stripe_len);
+            w.end = (s + 1 == num_stripes) ? path.size() : std::min(path.size(), w.begin + stripe_len);
+            w.segment.assign(path.begin() + w.begin, path.begin() + w.end);
+        }
+
+        runLNSRound(pool, shared, workers, num_stripes);
+
+        // Merge the improved stripes, in path order. A stripe that took an unused word
+        // an earlier stripe also took is dropped.
+        std::vector<uint32_t> merged(path.begin(), path.begin() + workers[0].begin);
+        size_t improvements = 0;
+        size_t kept = 0;
+        for (size_t s = 0; s < num_stripes; s++) {
+            lns_worker_t& w = workers[s];
+            iterations += w.attempts;
+            bool keep = w.improvements > 0;
+            for (size_t k = 0; k < w.segment.size() && keep; k++)
+                keep = shared.used[w.segment[k]] || claimed[w.segment[k]] != shared.round;
+            if (keep) {
+                for (uint32_t id : w.segment)
+                    if (!shared.used[id]) claimed[id] = shared.round;
+                merged.insert(merged.end(), w.segment.begin(), w.segment.end());
+                improvements += w.improvements;
+                kept++;
+            } else {
+                merged.insert(merged.end(), path.begin() + w.begin, path.begin() + w.end);
+                if (stats && w.improvements > 0)
+                    stats->dropped_stripes++;
+            }
+            attempt += w.attempts;
+        }
+        if (stats && kept > 1)
+            stats->merged_rounds++;
+        if (!improvements)
+            continue;
+
+        for (uint32_t id : path)
+            shared.used[id] = false;
+        path = std::move(merged);
+        for (uint32_t id : path)
+            shared.used[id] = true;
+
+        max_length = pathWeight(dict, path);
+        attempt = 0;
+        recordTrace(stats, start, max_length);
+        if (params.top)
+            offerPath(*params.top, path);
+        if (params.verbose)
+            std::cout << "length: " << max_length << '\n';
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        pool.stopping = true;
+    }
+    pool.start_cv.notify_all();
+    for (auto& t : pool.threads)
+        t.join();
+
+    if (params.verbose)
+        std::cout << "Found." << std::endl;
+
+    if (stats) stats->iterations = iterations;
+    return pathWords(dict.words, path);
+}
+
+
+/* ------------------ Dispatch ------------------------- */
+
+
+/* Runs an engine on a dictionary (or a kernel) */
+static std::list<std::string> runEngine(Algorithm algo,
+                                        const dictionary_t& dict,
+                                        const solve_params_t& params,
+                                        solve_stats_t* stats)
+{
+    switch (algo) {
+        case Algorithm::DFS:
+            return pathWords(dict.words, dfs(dict, params, stats));
+        case Algorithm::Greedy:
+            return solveGreedy(dict, params);
+        case Algorithm::HillClimbing:
+            return solveHillClimbing(dict, params, stats);
+        case Algorithm::SimulatedAnnealing:
+            return solveSimulatedAnnealing(dict, params, stats);
+        case Algorithm::RandomGreedy:
+            return solveRandomGreedy(dict, params, stats);
+        case Algorithm::LargeNeighbourhood:
+            return solveLargeNeighbourhood(dict, params, stats);
+    }
+    return {};
+}
+
+std::list<std::string> solve(Algorithm algo,
+                             const dictionary_t& dict,
+                             const solve_params_t& params,
+                             solve_stats_t* stats)
+{
+    if (numWords(dict.words) == 0)
+        return {};
+    if (params.constraints && !checkConstraints(dict, *params.constraints).empty())
+        return {};
+
+    auto start = Clock::now();
+    std::list<std::string> max_path;
+
+    // Search the kernel and expand the path found. Searches that refer to the dictionary's
+    // word IDs while they run (top-K, constraints, DFS checkpoints) search the dictionary itself.
+    if (params.kernelize.value_or(kernelByDefault(algo)) && !params.top && !params.constraints && params.checkpoint_path.empty() && !params.resume) {
+        kernel_t kernel = newKernel(dict);
+        solve_params_t kernel_params = params;
+        kernel_params.initial_path = kernelPath(kernel, params.initial_path);
+        max_path = expandPath(kernel, dict, runEngine(algo, kernel.dict, kernel_params, stats));
+    } else {
+        max_path = runEngine(algo, dict, params, stats);
+    }
+
+    // Engines that finish in one step (greedy) record their only result.
+    if (stats && stats->trace.empty())
+        recordTrace(stats, start, max_path.size());
+
+    return max_path;
+}
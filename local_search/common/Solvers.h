@@ -0,0 +1,197 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <list>
+#include <optional>
+#include "PathGeneration.h"
+
+/* ------------------ Parameters ------------------------- */
+
+
+/* Collector of the k longest distinct sequences (see TopK.h) */
+struct top_k_t;
+
+/* Start/end words, required and forbidden words of a sequence (see Constraints.h) */
+struct path_constraints_t;
+
+/* Search engines selectable by name */
+enum class Algorithm { DFS, Greedy, HillClimbing, SimulatedAnnealing, RandomGreedy, LargeNeighbourhood };
+
+/*
+ * Parameters for the search engines. Defaults are the values
+ * the standalone binaries have always used.
+ * time_limit: seconds an engine may search for, 0 means no limit.
+ * verbose: print search progress to std::cout.
+ * initial_path: word IDs the local searches start from instead of the greedy path (warm start),
+ *   e.g. a previous best path repaired with repairPath. Ignored when empty.
+ * checkpoint_path: file the DFS saves its full state to every checkpoint_interval seconds
+ *   and when it stops (see Checkpoint.h). Empty for none.
+ * resume: the DFS continues from the state saved in checkpoint_path, if there is one for the dictionary.
+ * top: if set, the engines also offer it every sequence they consider: the DFS each path it cannot
+ *   extend, the local searches each candidate path (see solveTopK).
+ * constraints: if set, the engines only return sequences meeting them, pruning with them as they search:
+ *   words that cannot appear are visited from the start, the search grows away from an anchored word,
+ *   and the DFS drops a branch once a required word it lacks is out of reach. The DFS cannot be resumed
+ *   from (or checkpointed for) a constrained search.
+ * exact: the DFS frees a word again when it backtracks past it, so it tries every simple path and returns a
+ *   longest sequence, in exponential time. Without it every word is expanded at most once.
+ * workers: threads the large neighbourhood search repairs disjoint stripes of its path on (a pool kept for the search).
+ * min_stripe: fewest words of a stripe (at least 3), 0 for the default of the longest window plus its two ends.
+ *   Lower values split short paths too, which the fuzzer uses to exercise the stripe merge.
+ * kernelize: solve searches the dictionary's kernel (see Kernel.h) and expands the path found, unless the
+ *   search refers to the dictionary's word IDs while it runs (top, constraints, checkpoint_path, resume).
+ *   Unset for the engine's default (kernelByDefault).
+ */
+struct solve_params_t {
+    double time_limit = 0;
+    size_t max_attempts = 1000;     // Hill climbing, random greedy and large neighbourhood search.
+    double temperature = 5000;      // Simulated annealing.
+    double cooling_factor = 0.99;   // Simulated annealing.
+    SampleMode sample_mode = SampleMode::Uniform;
+    bool verbose = false;
+    std::vector<uint32_t> initial_path;
+    std::string checkpoint_path;
+    double checkpoint_interval = 60;
+    bool resume = false;
+    top_k_t* top = nullptr;
+    const path_constraints_t* constraints = nullptr;
+    bool exact = false;             // DFS.
+    int workers = 1;                // Large neighbourhood search.
+    size_t min_stripe = 0;          // Large neighbourhood search.
+    std::optional<bool> kernelize;
+};
+
+/*
+ * Statistics reported by a search engine.
+ * trace: (seconds since the engine started, length) each time the longest path found grew.
+ * merged_rounds: large neighbourhood search rounds that kept the improvements of more than one stripe.
+ * dropped_stripes: improved stripes it dropped because they took an unused word an earlier stripe took.
+ */
+struct solve_stats_t {
+    size_t iterations = 0;
+    std::vector<std::pair<double, size_t>> trace;
+    size_t merged_rounds = 0;
+    size_t dropped_stripes = 0;
+};
+
+/* Parses an algorithm name (dfs, greedy, hill, sa, random-greedy, lns). Returns false if unknown. */
+bool parseAlgorithm(const std::string& name, Algorithm& algo);
+
+std::string algorithmName(Algorithm algo);
+
+/*
+ * True if solve searches the kernel for algo unless solve_params_t::kernelize says otherwise.
+ * Every engine but simulated annealing: its final path is its current one, and it scores lower on the kernel.
+ */
+bool kernelByDefault(Algorithm algo);
+
+
+/* ------------------ Search Engines ------------------------- */
+
+
+/* Pushed below a word's successors on the DFS stack, popping it triggers a backtrack */
+const uint32_t DFSBacktrack = UINT32_MAX;
+
+/*
+ * Full state of a depth first search, enough to continue it exactly where it stopped.
+ * stack: words still to expand and backtrack markers, top at the back. Each word sits above its
+ *   marker, so the successors left to try at every depth (the frames' cursors) are all on the stack.
+ * root_base: stack[0, root_base) are the (marker, word) pairs of root words not started yet.
+ * exact: the search frees words on backtrack (solve_params_t::exact), so visited only holds the current path
+ *   (and the words constraints rule out). A state is only continued in the mode it was run in.
+ */
+struct dfs_state_t {
+    std::vector<uint32_t> stack;
+    size_t root_base = 0;
+    std::vector<uint32_t> current_path;
+    std::vector<bool> visited;
+    std::vector<uint32_t> max_path;
+    uint64_t iterations = 0;
+    bool exact = false;
+};
+
+/*
+ * State of a search that has not started: every word is a root (in word ID order).
+ * With constraints, words that cannot appear start out visited and only the anchored word
+ * (the start word, else the end word) is a root.
+ */
+dfs_state_t newDFSState(const dictionary_t& dict, const path_constraints_t* constraints = nullptr);
+
+/*
+ * True if a constrained DFS runs backward, from the end word: when only the end is anchored.
+ * Its paths are built last word first.
+ */
+bool searchesBackward(const path_constraints_t* constraints);
+
+/*
+ * (DFS node expansion).
+ * Takes a stack and appends a viable sequence of word IDs
+ * from a starting word that have not been visited.
+ * If backward is true: appends the words that can come before the starting word.
+ */
+void appendSequence(std::vector<uint32_t>& s,
+                    uint32_t start_word,
+                    const std::vector<bool>& visited,
+                    const dictionary_t& dict,
+                    bool backward = false);
+
+/*
+ * Continues a depth first search from state until the stack is empty or the time limit is reached,
+ * saving the state to params.checkpoint_path (if set) every params.checkpoint_interval seconds
+ * and when it stops. With params.constraints, max_path only ever holds a path meeting them
+ * (last word first if the search runs backward).
+ */
+void runDFS(const dictionary_t& dict,
+            dfs_state_t& state,
+            const solve_params_t& params,
+            solve_stats_t* stats = nullptr);
+
+/*
+ * Performs a depth first search on all words in the dictionary (in word ID order).
+ * Following the sequence previous 2nd and 3rd letters match current
+ * 2nd last and 3rd last letters.
+ * With params.resume, continues the search saved in params.checkpoint_path instead.
+ * @return maximum sequence found.
+ */
+std::vector<uint32_t> dfs(const dictionary_t& dict,
+                          const solve_params_t& params,
+                          solve_stats_t* stats = nullptr);
+
+/* Returns the greedy path of the dictionary (grown from a word meeting params.constraints, if set) */
+std::list<std::string> solveGreedy(const dictionary_t& dict, const solve_params_t& params = solve_params_t());
+
+/* Attempts to find the longest sequence using a hill climbing algorithm */
+std::list<std::string> solveHillClimbing(const dictionary_t& dict,
+                                         const solve_params_t& params,
+                                         solve_stats_t* stats = nullptr);
+
+/* Attempts to find the longest sequence using a simulated annealing algorithm */
+std::list<std::string> solveSimulatedAnnealing(const dictionary_t& dict,
+                                               const solve_params_t& params,
+                                               solve_stats_t* stats = nullptr);
+
+/* Attempts to find the longest sequence using a greedy algorithm with random backtracking/restart */
+std::list<std::string> solveRandomGreedy(const dictionary_t& dict,
+                                         const solve_params_t& params,
+                                         solve_stats_t* stats = nullptr);
+
+/*
+ * Attempts to find the longest sequence by large neighbourhood search: starting from the greedy (or warm start)
+ * path, repeatedly destroys an interior window of the path and refills the gap with the longest trail of free
+ * words (the window's and the unused ones) between its neighbours, found by a bounded DFS.
+ * Window sizes are drawn by their recent success, and params.workers threads repair disjoint stripes at once.
+ * The ends of the path never change.
+ */
+std::list<std::string> solveLargeNeighbourhood(const dictionary_t& dict,
+                                               const solve_params_t& params,
+                                               solve_stats_t* stats = nullptr);
+
+/*
+ * Runs the given engine on a loaded dictionary.
+ * Returns an empty path if params.constraints cannot be met (see checkConstraints).
+ */
+std::list<std::string> solve(Algorithm algo,
+                             const dictionary_t& dict,
+                             const solve_params_t& params,
+                             solve_stats_t* stats = nullptr);
@@ -0,0 +1,165 @@
+#include "Synthetic.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cmath>
+
+/* ------------------ Synthetic Dictionaries ------------------------- */
+
+
+bool parseLengthMix(const std::string& arg, std::vector<std::pair<int, double>>& lengths)
+{
+    std::vector<std::pair<int, double>> parsed;
+    std::stringstream ss(arg);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        int first, last;
+        double weight = 1;
+        char extra;
+        size_t colon = item.find(':');
+        std::string range = item.substr(0, colon);
+        if (colon != std::string::npos && std::sscanf(item.c_str() + colon + 1, "%lf%c", &weight, &extra) != 1)
+            return false;
+        if (std::sscanf(range.c_str(), "%d-%d%c", &first, &last, &extra) == 2) {
+            // A range.
+        } else if (std::sscanf(range.c_str(), "%d%c", &first, &extra) == 1) {
+            last = first;
+        } else {
+            return false;
+        }
+        if (first < 1 || last < first || !(weight > 0))
+            return false;
+        for (int len = first; len <= last; len++)
+            parsed.emplace_back(len, weight);
+    }
+    if (parsed.empty())
+        return false;
+    lengths = std::move(parsed);
+    return true;
+}
+
+bool parseCount(const std::string& arg, size_t& count)
+{
+    double value;
+    char suffix = 0, extra;
+    int n = std::sscanf(arg.c_str(), "%lf%c%c", &value, &suffix, &extra);
+    if (n < 1 || n > 2 || value < 0)
+        return false;
+    if (n == 2 && suffix != 'k' && suffix != 'M')
+        return false;
+    count = (size_t)std::llround(value * ((suffix == 'k') ? 1e3 : (suffix == 'M') ? 1e6 : 1));
+    return true;
+}
+
+std::string checkSyntheticParams(const synthetic_params_t& params)
+{
+    if (params.letters < 1 || params.letters > 26)
+        return "the alphabet must have 1 to 26 letters";
+    if (params.lengths.empty())
+        return "no word lengths";
+    for (const auto& [len, weight] : params.lengths) {
+        if (len < minWordLength(params.rule))
+            return "word length " + std::to_string(len) + " cannot hold the keys of rule " + ruleName(params.rule);
+        if (!(weight > 0))
+            return "word length weights must be positive";
+    }
+    if (params.skew < 0)
+        return "the skew must not be negative";
+    return "";
+}
+
+/* Uniform double in [0, 1) from the generator's next 53 bits (the same on every platform) */
+static double unitDouble(std::mt19937_64& rng)
+{
+    return (rng() >> 11) * 0x1.0p-53;
+}
+
+/* Index drawn from a cumulative weight table */
+static size_t drawIndex(std::mt19937_64& rng, const std::vector<double>& cumulative)
+{
+    double x = unitDouble(rng) * cumulative.back();
+    size_t i = std::upper_bound(cumulative.begin(), cumulative.end(), x) - cumulative.begin();
+    return std::min(i, cumulative.size() - 1);
+}
+
+/* FNV-1a hash of a word, never 0 (the empty slot of the seen table) */
+static uint64_t wordHash(std::string_view word)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (char c : word)
+        hash = (hash ^ (unsigned char)c) * 1099511628211ull;
+    return (hash) ? hash : 1;
+}
+
+size_t generateWords(const synthetic_params_t& params, const std::function<void(std::string_view)>& emit)
+{
+    std::mt19937_64 rng(params.seed);
+    const overlap_rule_t& rule = params.rule;
+
+    std::vector<double> length_weights;
+    for (const auto& length : params.lengths)
+        length_weights.push_back(((length_weights.empty()) ? 0 : length_weights.back()) + length.second);
+
+    // Key ranks map to keys in a random order, so the frequent keys are not always the first letters.
+    size_t num_keys = std::pow(params.letters, rule.key_len);
+    std::vector<uint32_t> key_of_rank(num_keys);
+    std::vector<double> key_weights(num_keys);
+    for (size_t r = 0; r < num_keys; r++) {
+        key_of_rank[r] = r;
+        key_weights[r] = ((r) ? key_weights[r-1] : 0) + 1 / std::pow(r + 1, params.skew);
+    }
+    for (size_t r = num_keys - 1; r > 0; r--)
+        std::swap(key_of_rank[r], key_of_rank[rng() % (r + 1)]);
+
+    // Writes key number key (in base letters) at pos.
+    auto placeKey = [&](std::string& word, int pos, uint32_t key) {
+        for (int i = rule.key_len - 1; i >= 0; i--, key /= params.letters)
+            word[pos + i] = 'a' + key % params.letters;
+    };
+
+    // Open addressing table of the hashes of the words emitted so far (0 is empty). Distinct words
+    // whose hashes collide count as repeats, which only costs a draw.
+    size_t slots = 16;
+    while (slots < params.num_words + params.num_words / 3)
+        slots *= 2;
+    std::vector<uint64_t> seen(slots);
+
+    size_t generated = 0;
+    size_t max_draws = 10 * params.num_words + 1000;
+    std::string word;
+    for (size_t draws = 0; generated < params.num_words && draws < max_draws; draws++) {
+        int len = params.lengths[drawIndex(rng, length_weights)].first;
+        word.resize(len);
+        for (char& letter : word)
+            letter = 'a' + rng() % params.letters;
+        placeKey(word, len - rule.back_offset, key_of_rank[drawIndex(rng, key_weights)]);
+        placeKey(word, rule.front_offset, key_of_rank[drawIndex(rng, key_weights)]);
+
+        uint64_t hash = wordHash(word);
+        size_t slot = hash & (slots - 1);
+        while (seen[slot] && seen[slot] != hash)
+            slot = (slot + 1) & (slots - 1);
+        if (seen[slot])
+            continue; // a repeat.
+        seen[slot] = hash;
+        emit(word);
+        generated++;
+    }
+    return generated;
+}
+
+long writeSyntheticWords(const std::string& filepath, const synthetic_params_t& params)
+{
+    std::ofstream out(filepath);
+    if (!out) {
+        std::cerr << "Cannot write to " << filepath << '\n';
+        return -1;
+    }
+    size_t generated = generateWords(params, [&](std::string_view word) { out << word << '\n'; });
+    out.close();
+    if (!out) {
+        std::cerr << "Cannot write to " << filepath << '\n';
+        return -1;
+    }
+    return generated;
+}
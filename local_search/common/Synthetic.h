@@ -0,0 +1,60 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <functional>
+#include "PathGeneration.h"
+
+/* ------------------ Synthetic Dictionaries ------------------------- */
+
+/*
+ * Parameters of a synthetic word list, for benchmarking beyond dictionary.txt.
+ * num_words: number of distinct words to generate.
+ * lengths: (word length, weight) pairs, each word's length is drawn in proportion to the weights.
+ * letters: size of the alphabet, the first letters of a..z.
+ * skew: Zipf exponent of the key frequencies. Keys are ranked in a random order and key rank r (from 1)
+ *   is drawn with probability proportional to 1/r^skew: 0 is uniform, 1 is Zipfian, larger is more skewed.
+ * rule: the rule whose front and back keys are drawn from the skewed distribution, the other letters are uniform.
+ * seed: the same parameters and seed always give the same list.
+ */
+struct synthetic_params_t {
+    size_t num_words = 100000;
+    std::vector<std::pair<int, double>> lengths{{4, 1}, {5, 1}, {6, 1}, {7, 1}, {8, 1}, {9, 1},
+                                                {10, 1}, {11, 1}, {12, 1}, {13, 1}, {14, 1}, {15, 1}};
+    int letters = 26;
+    double skew = 0;
+    overlap_rule_t rule;
+    uint64_t seed = 1;
+};
+
+/*
+ * Parses a length mix: comma separated word lengths or ranges, each with an optional weight,
+ * such as "4-15" (every length equally likely) or "4-6:1,7-9:3". Returns false if the mix is malformed.
+ */
+bool parseLengthMix(const std::string& arg, std::vector<std::pair<int, double>>& lengths);
+
+/*
+ * Parses a count with an optional k (thousand) or M (million) suffix, such as "10k" or "1M".
+ * Returns false if the count is malformed.
+ */
+bool parseCount(const std::string& arg, size_t& count);
+
+/*
+ * Returns an empty string if the parameters can generate words (every length holds the rule's keys,
+ * the weights are positive and the alphabet is 1..26 letters), otherwise what is wrong with them.
+ */
+std::string checkSyntheticParams(const synthetic_params_t& params);
+
+/*
+ * Generates the words of a synthetic list in order, calling emit for each. Repeated words are drawn again.
+ * Returns the number of words generated, fewer than num_words if the lengths and alphabet run out of
+ * distinct words (after a bounded number of draws).
+ */
+size_t generateWords(const synthetic_params_t& params, const std::function<void(std::string_view)>& emit);
+
+/*
+ * Writes a synthetic list to filepath, one word per line.
+ * Returns the number of words written, or -1 if the file cannot be written.
+ */
+long writeSyntheticWords(const std::string& filepath, const synthetic_params_t& params);
@@ -0,0 +1,153 @@
+#include "TopK.h"
+#include "Checkpoint.h"
+#include <thread>
+
+/* ------------------ Top-K Sequences ------------------------- */
+
+
+/* Order independent hash of a word ID set: a sum of mixed IDs */
+static uint64_t wordSetHash(const std::vector<uint32_t>& path)
+{
+    uint64_t h = path.size();
+    for (uint32_t id : path) {
+        uint64_t x = id + 0x9e3779b97f4a7c15ull;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+        h += x ^ (x >> 31);
+    }
+    return h;
+}
+
+double pathDistance(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b)
+{
+    size_t longest = std::max(a.size(), b.size());
+    if (longest == 0)
+        return 0;
+
+    size_t shared = 0;
+    auto i = a.begin(), j = b.begin();
+    while (i != a.end() && j != b.end()) {
+        if (*i < *j) i++;
+        else if (*j < *i) j++;
+        else { shared++; i++; j++; }
+    }
+    return (double)(longest - shared) / longest;
+}
+
+bool offerPath(top_k_t& top, const std::vector<uint32_t>& path)
+{
+    if (path.empty() || top.k == 0)
+        return false;
+    uint64_t hash = wordSetHash(path);
+
+    std::lock_guard<std::mutex> lock(top.mutex);
+    if (path.size() <= top.min_length)
+        return false;
+    for (const top_k_entry_t& entry : top.entries) {
+        if (entry.hash == hash && entry.path.size() == path.size())
+            return false; // same word set.
+    }
+
+    top_k_entry_t candidate;
+    candidate.path = path;
+    candidate.words = path;
+    candidate.hash = hash;
+    std::sort(candidate.words.begin(), candidate.words.end());
+
+    // Sequences too close to the candidate: it must be longer than all of them and replaces them.
+    std::vector<size_t> near;
+    for (size_t i = 0; i < top.entries.size(); i++) {
+        if (pathDistance(candidate.words, top.entries[i].words) < top.diversity) {
+            if (top.entries[i].path.size() >= path.size())
+                return false;
+            near.push_back(i);
+        }
+    }
+    for (auto it = near.rbegin(); it != near.rend(); ++it)
+        top.entries.erase(top.entries.begin() + *it);
+    top.entries.push_back(std::move(candidate));
+
+    // Drop the shortest beyond k, and publish the length a sequence must now beat.
+    auto shortest = [&]() {
+        return std::min_element(top.entries.begin(), top.entries.end(), [](const auto& a, const auto& b) {
+            return a.path.size() < b.path.size();
+        });
+    };
+    if (top.entries.size() > top.k)
+        top.entries.erase(shortest());
+    top.min_length = (top.entries.size() >= top.k) ? shortest()->path.size() : 0;
+    return true;
+}
+
+std::vector<std::vector<uint32_t>> topPaths(top_k_t& top)
+{
+    std::lock_guard<std::mutex> lock(top.mutex);
+    std::vector<std::vector<uint32_t>> paths;
+    for (const top_k_entry_t& entry : top.entries)
+        paths.push_back(entry.path);
+    std::stable_sort(paths.begin(), paths.end(), [](const auto& a, const auto& b) { return a.size() > b.size(); });
+    return paths;
+}
+
+std::vector<std::list<std::string>> solveTopK(Algorithm algo,
+                                              const dictionary_t& dict,
+                                              const solve_params_t& params,
+                                              size_t k,
+                                              double diversity,
+                                              int num_threads,
+                                              uint32_t seed,
+                                              solve_stats_t* stats)
+{
+    top_k_t top;
+    top.k = k;
+    top.diversity = diversity;
+    solve_params_t top_params = params;
+    top_params.top = &top;
+    top_params.checkpoint_path.clear(); // a shard of the search is not the search.
+
+    if (algo == Algorithm::Greedy || numWords(dict.words) == 0)
+        num_threads = 1;
+    num_threads = std::max(1, num_threads);
+
+    std::vector<dfs_state_t> shards;
+    if (algo == Algorithm::DFS)
+        shards = splitDFSState(newDFSState(dict, params.constraints), num_threads);
+
+    std::vector<solve_stats_t> thread_stats(num_threads);
+    auto run = [&](int t) {
+        if (!shards.empty()) {
+            runDFS(dict, shards[t], top_params, &thread_stats[t]);
+            std::vector<uint32_t>& max_path = shards[t].max_path;
+            if (searchesBackward(params.constraints))
+                std::reverse(max_path.begin(), max_path.end());
+            offerPath(top, max_path);
+            return;
+        }
+        seedRandom(seed + t);
+        std::list<std::string> path = solve(algo, dict, top_params, &thread_stats[t]);
+        std::vector<uint32_t> ids;
+        for (const std::string& word : path)
+            ids.push_back(findWord(dict, word));
+        offerPath(top, ids);
+    };
+
+    std::vector<std::thread> threads;
+    for (int t = 1; t < num_threads; t++)
+        threads.emplace_back(run, t);
+    run(0);
+    for (std::thread& thread : threads)
+        thread.join();
+
+    if (stats) {
+        for (const solve_stats_t& s : thread_stats) {
+            stats->iterations += s.iterations;
+            stats->merged_rounds += s.merged_rounds;
+            stats->dropped_stripes += s.dropped_stripes;
+        }
+    }
+
+    std::vector<std::list<std::string>> paths;
+    for (const auto& path : topPaths(top))
+        paths.push_back(pathWords(dict.words, path));
+    return paths;
+}
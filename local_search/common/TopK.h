@@ -0,0 +1,68 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <list>
+#include <mutex>
+#include <atomic>
+#include "Solvers.h"
+
+/* ------------------ Top-K Sequences ------------------------- */
+
+/*
+ * Collects the k longest sequences offered by the engines that are distinct from each other.
+ * The distance of two sequences is the share of words in the longer one that the other
+ * does not hold: max(|A \ B|, |B \ A|) / max(|A|, |B|), a lower bound on their word level
+ * edit distance (relative to the longer sequence). A sequence closer than "diversity" to a
+ * kept one only replaces it if it is longer, so the kept sequences are always pairwise distinct.
+ * A sequence with the word set of a kept one is dropped by its set hash alone.
+ * Safe to offer to from several threads.
+ */
+struct top_k_entry_t {
+    std::vector<uint32_t> path;
+    std::vector<uint32_t> words;    // path's word IDs, sorted.
+    uint64_t hash = 0;              // hash of the word set.
+};
+
+struct top_k_t {
+    size_t k = 10;
+    double diversity = 0.1;
+    std::mutex mutex;
+    std::vector<top_k_entry_t> entries;
+    std::atomic<size_t> min_length{0};  // a sequence must be longer to enter, once k are kept.
+};
+
+/*
+ * Offers a sequence of word IDs, returns true if it was kept.
+ * Takes the mutex only for sequences longer than the shortest kept one (once k are kept).
+ */
+bool offerPath(top_k_t& top, const std::vector<uint32_t>& path);
+
+template <typename Path>
+bool offerPath(top_k_t& top, const Path& path)
+{
+    if (path.size() <= top.min_length.load(std::memory_order_relaxed))
+        return false;
+    return offerPath(top, std::vector<uint32_t>(path.begin(), path.end()));
+}
+
+/* Distance of two sorted word ID sets (see top_k_t) */
+double pathDistance(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b);
+
+/* The kept sequences of word IDs, longest first */
+std::vector<std::vector<uint32_t>> topPaths(top_k_t& top);
+
+/*
+ * Runs num_threads searches of the chosen algorithm at once, all offering the sequences they
+ * consider to one top-K collector, and returns the k longest distinct sequences (longest first).
+ * The DFS splits its root words between the threads (see splitDFSState), the local searches
+ * each run from their own seed (seed + thread index). Greedy is deterministic and runs once.
+ */
+std::vector<std::list<std::string>> solveTopK(Algorithm algo,
+                                              const dictionary_t& dict,
+                                              const solve_params_t& params,
+                                              size_t k,
+                                              double diversity,
+                                              int num_threads,
+                                              uint32_t seed,
+                                              solve_stats_t* stats = nullptr);
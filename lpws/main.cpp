@@ -0,0 +1,742 @@
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <cstdio>
+#include <filesystem>
+#include "../local_search/common/Dictionary.h"
+#include "../local_search/common/Solvers.h"
+#include "../local_search/common/PerfCounters.h"
+#include "../local_search/common/AllocCounter.h"
+#include "../local_search/common/Pipeline.h"
+#include "../local_search/common/SolutionCache.h"
+#include "../local_search/common/Checkpoint.h"
+#include "../local_search/common/TopK.h"
+#include "../local_search/common/Constraints.h"
+#include "../include/VariadicTable.h"
+
+/*
+ * Command line driver running any of the algorithms for solving the longest sequence problem.
+ *
+ * Build with : cmake -S . -B build && cmake --build build --target lpws
+ */
+
+/* Dictionary file (the build sets this to the repository's dictionary.txt) */
+#ifndef DICTIONARY_PATH
+#define DICTIONARY_PATH "dictionary.txt"
+#endif
+
+/*
+ * Table structure for printing results to console.
+ */
+typedef VariadicTable<std::string, size_t, size_t, double, double, size_t, std::string> TableFormat;
+
+/*
+ * Table structure for printing results with deltas applied to console.
+ */
+typedef VariadicTable<std::string, size_t, size_t, size_t, double, double, size_t, std::string> DeltaTableFormat;
+
+/*
+ * Table structure for printing the top-K sequences to console.
+ */
+typedef VariadicTable<std::string, size_t, size_t, double, std::string> TopTableFormat;
+
+/*
+ * Table structure for printing hardware counters to console.
+ */
+typedef VariadicTable<std::string, std::string, long long, long long, long long, long long, long long> PerfTableFormat;
+
+/*
+ * Table structure for printing allocation counts to console.
+ */
+typedef VariadicTable<std::string, std::string, size_t, size_t, size_t, double, double> AllocTableFormat;
+
+/* Chrono clock */
+typedef std::chrono::steady_clock Clock;
+
+/* Solver phases measured with hardware counters */
+enum Phase { LoadPhase, BuildPhase, SearchPhase, ValidatePhase, NumPhases };
+const char* phase_names[NumPhases] = {"load", "build", "search", "validate"};
+
+/* Output formats */
+enum class Output { Table, CSV, JSON };
+
+/* Command line options */
+struct options_t {
+    Algorithm algo = Algorithm::SimulatedAnnealing;
+    std::vector<int> lengths;
+    int threads = 1;
+    size_t prefetch = 1;
+    uint32_t seed = 0;
+    std::string dict_path = DICTIONARY_PATH;
+    Output output = Output::Table;
+    bool perf = false;
+    std::vector<std::string> deltas;
+    double delta_time_limit = 1;
+    overlap_rule_t rule;
+    std::string cache_dir;
+    std::string checkpoint_dir;
+    size_t shards = 0;
+    size_t top = 0;
+    double diversity = 0.1;
+    constraint_words_t constraints;
+    solve_params_t params;
+};
+
+/* Result for one word length */
+struct result_t {
+    int word_len = 0;
+    int delta = 0;      // number of deltas applied.
+    size_t num_words = 0;
+    size_t seq_length = 0;
+    double found = 0;
+    double total = 0;
+    size_t iterations = 0;
+    bool correct = false;
+    std::vector<std::list<std::string>> top;    // with --top, longest first (top[0] is the path).
+    std::vector<double> top_distance;           // distance of each top sequence to the first.
+    std::vector<bool> top_correct;
+    perf_counts_t perf[NumPhases];
+    alloc_counts_t allocs[NumPhases];
+};
+
+
+void printUsage(std::ostream& out)
+{
+    out << "Usage: lpws [options]\n"
+        << "  --algo NAME           dfs, greedy, hill, sa, random-greedy or lns (default: sa)\n"
+        << "  --lengths LIST        word lengths, e.g. 4-15, 8 or 5,7,9-11, or mixed for one graph of all lengths (default: 4-15)\n"
+        << "  --time-limit SEC      search time budget per word length, 0 for none (default: 0)\n"
+        << "  --threads N           word lengths solved concurrently (default: 1)\n"
+        << "  --prefetch N          word lengths loaded ahead of the search, 0 to load on the solving thread (default: 1)\n"
+        << "  --seed N              random seed (default: random)\n"
+        << "  --dict PATH           dictionary file (default: " DICTIONARY_PATH ")\n"
+        << "  --output FORMAT       table, csv or json (default: table)\n"
+        << "  --rule NAME           overlap rule: default, overlap3, first-last or kK-fF-bB[-i]\n"
+        << "                        (key length, front offset, back offset, -i to ignore case) (default: default)\n"
+        << "  --max-attempts N      hill, random-greedy and lns failed attempts before stopping (default: 1000)\n"
+        << "  --lns-workers N       lns threads repairing disjoint stripes of the path (default: 1)\n"
+        << "  --temperature T       sa initial temperature (default: 5000)\n"
+        << "  --cooling-factor F    sa cooling factor (default: 0.99)\n"
+        << "  --sample MODE         restart word distribution, uniform or degree (default: uniform)\n"
+        << "  --delta PATH          word list changes (+word/-word) applied after the search, each re-solved\n"
+        << "                        from the repaired previous path; may be repeated\n"
+        << "  --delta-time-limit S  search time budget of each re-solve after a delta, 0 for none (default: 1)\n"
+        << "  --cache DIR           start from the best path stored in DIR and store better ones (default: off)\n"
+        << "  --checkpoint DIR      dfs saves its state to DIR/dfs-LEN.ckpt as it runs and when it stops (default: off)\n"
+        << "  --checkpoint-every S  seconds between dfs checkpoints (default: 60)\n"
+        << "  --resume              dfs continues from the checkpoints in --checkpoint DIR\n"
+        << "  --shards N            split the remaining work of the checkpoints in --checkpoint DIR into\n"
+        << "                        DIR/shard-K/ (K = 0..N-1), each resumable on its own, then exit\n"
+        << "  --top K               keep the K longest sequences that are distinct from each other, found by\n"
+        << "                        --threads searches of each word length at once (default: 0, off)\n"
+        << "  --diversity D         share of words (0..1) two top sequences must differ in (default: 0.1)\n"
+        << "  --start WORD          sequences must start with WORD (word lengths without it find none)\n"
+        << "  --end WORD            sequences must end with WORD\n"
+        << "  --require LIST        comma separated words every sequence must hold\n"
+        << "  --forbid LIST         comma separated words no sequence may hold\n"
+        << "  --exact               dfs tries every simple path (exponential time) instead of expanding\n"
+        << "                        every word once, so it finds a longest sequence\n"
+        << "  --no-kernel           search the whole dictionary instead of its kernel (self-loops folded,\n"
+        << "                        chains contracted, duplicate dead ends dropped); the default for sa\n"
+        << "  --kernel              search the kernel with every engine, sa included\n"
+        << "  --perf                record hardware counters for the load, build, search and validate phases\n";
+}
+
+/*
+ * Parses the command line into opts.
+ * Returns false (after printing the reason) if the command line is invalid.
+ */
+bool parseOptions(int argc, char* argv[], options_t& opts)
+{
+    bool seeded = false;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage(std::cout);
+            std::exit(0);
+        }
+        if (arg == "--perf") {
+            opts.perf = true;
+            continue;
+        }
+        if (arg == "--resume") {
+            opts.params.resume = true;
+            continue;
+        }
+        if (arg == "--exact") {
+            opts.params.exact = true;
+            continue;
+        }
+        if (arg == "--no-kernel") {
+            opts.params.kernelize = false;
+            continue;
+        }
+        if (arg == "--kernel") {
+            opts.params.kernelize = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << '\n';
+            return false;
+        }
+        std::string value = argv[++i];
+
+        try {
+            if (arg == "--algo") {
+                if (!parseAlgorithm(value, opts.algo)) {
+                    std::cerr << "Unknown algorithm: " << value << '\n';
+                    return false;
+                }
+            } else if (arg == "--lengths") {
+                if (!parseLengths(value, opts.lengths)) {
+                    std::cerr << "Invalid word lengths: " << value << '\n';
+                    return false;
+                }
+            } else if (arg == "--time-limit") {
+                opts.params.time_limit = std::stod(value);
+            } else if (arg == "--threads") {
+                opts.threads = std::max(1, std::stoi(value));
+            } else if (arg == "--prefetch") {
+                opts.prefetch = std::max(0, std::stoi(value));
+            } else if (arg == "--seed") {
+                opts.seed = std::stoul(value);
+                seeded = true;
+            } else if (arg == "--delta") {
+                opts.deltas.push_back(value);
+            } else if (arg == "--delta-time-limit") {
+                opts.delta_time_limit = std::stod(value);
+            } else if (arg == "--cache") {
+                opts.cache_dir = value;
+            } else if (arg == "--checkpoint") {
+                opts.checkpoint_dir = value;
+            } else if (arg == "--checkpoint-every") {
+                opts.params.checkpoint_interval = std::stod(value);
+            } else if (arg == "--top") {
+                opts.top = std::stoul(value);
+            } else if (arg == "--diversity") {
+                opts.diversity = std::stod(value);
+            } else if (arg == "--start") {
+                opts.constraints.start = value;
+            } else if (arg == "--end") {
+                opts.constraints.end = value;
+            } else if (arg == "--require") {
+                for (const std::string& word : splitWords(value))
+                    opts.constraints.required.push_back(word);
+            } else if (arg == "--forbid") {
+                for (const std::string& word : splitWords(value))
+                    opts.constraints.forbidden.push_back(word);
+            } else if (arg == "--shards") {
+                opts.shards = std::max(1, std::stoi(value));
+            } else if (arg == "--rule") {
+                if (!parseRule(value, opts.rule)) {
+                    std::cerr << "Invalid overlap rule: " << value << '\n';
+                    return false;
+                }
+            } else if (arg == "--dict") {
+                opts.dict_path = value;
+            } else if (arg == "--output") {
+                if (value == "table") opts.output = Output::Table;
+                else if (value == "csv") opts.output = Output::CSV;
+                else if (value == "json") opts.output = Output::JSON;
+                else {
+                    std::cerr << "Unknown output format: " << value << '\n';
+                    return false;
+                }
+            } else if (arg == "--max-attempts") {
+                opts.params.max_attempts = std::stoul(value);
+            } else if (arg == "--lns-workers") {
+                opts.params.workers = std::max(1, std::stoi(value));
+            } else if (arg == "--temperature") {
+                opts.params.temperature = std::stod(value);
+            } else if (arg == "--cooling-factor") {
+                opts.params.cooling_factor = std::stod(value);
+            } else if (arg == "--sample") {
+                if (value == "uniform") opts.params.sample_mode = SampleMode::Uniform;
+                else if (value == "degree") opts.params.sample_mode = SampleMode::Degree;
+                else {
+                    std::cerr << "Unknown sample mode: " << value << '\n';
+                    return false;
+                }
+            } else {
+                std::cerr << "Unknown option: " << arg << '\n';
+                return false;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Invalid value for " << arg << ": " << value << '\n';
+            return false;
+        }
+    }
+
+    if (opts.lengths.empty())
+        parseLengths("4-15", opts.lengths);
+
+    if ((opts.params.resume || opts.shards) && opts.checkpoint_dir.empty()) {
+        std::cerr << "--resume and --shards need --checkpoint DIR\n";
+        return false;
+    }
+
+    // A checkpoint does not record the constraints its search ran under.
+    if (isConstrained(opts.constraints) && !opts.checkpoint_dir.empty()) {
+        std::cerr << "--checkpoint cannot be combined with --start, --end, --require or --forbid\n";
+        return false;
+    }
+
+    // Always run with a known seed so any run can be reproduced.
+    if (!seeded)
+        opts.seed = std::random_device{}();
+
+    return true;
+}
+
+
+/*
+ * Dictionary of a word length while it moves through the pipeline, and the path found
+ * for it before and after each delta.
+ */
+struct job_t {
+    dictionary_t dict;
+    std::vector<std::list<std::string>> paths;
+    std::vector<std::list<std::string>> top;
+};
+
+/*
+ * Runs one phase of a word length and returns its wall time in seconds. Hardware counters are
+ * only recorded when asked for, heap allocations when built with LPWS_COUNT_ALLOCS. The phases
+ * of a word length may run on different threads, so each opens counters for its own thread.
+ */
+template <typename Fn>
+double measurePhase(const options_t& opts, Phase phase, result_t& result, Fn fn)
+{
+    perf_group_t perf = openPerfCounters();
+    if (!opts.perf)
+        closePerfCounters(perf);
+
+    auto start = Clock::now();
+    alloc_counts_t allocs_start = allocCounts();
+    startPerfCounters(perf);
+    fn();
+    result.perf[phase] = stopPerfCounters(perf);
+    result.allocs[phase] = allocCounts() - allocs_start;
+    auto end = Clock::now();
+
+    closePerfCounters(perf);
+    return std::chrono::duration<double>(end - start).count();
+}
+
+/*
+ * Reads and builds the dictionary for words of size word_len.
+ * Returns false if the dictionary cannot be read.
+ */
+bool loadWordLength(int word_len, const options_t& opts, job_t& job, result_t& result)
+{
+    bool loaded = false;
+    result.word_len = word_len;
+    result.total = measurePhase(opts, LoadPhase, result, [&]() {
+        job.dict.rule = opts.rule;
+        loaded = readWords(opts.dict_path, word_len, job.dict.words, opts.rule);
+    });
+    if (!loaded)
+        return false;
+
+    result.total += measurePhase(opts, BuildPhase, result, [&]() { buildDictionary(job.dict); });
+    result.num_words = numWords(job.dict.words);
+    return true;
+}
+
+/* DFS checkpoint of a word length within a checkpoint directory */
+std::string checkpointPath(const std::string& dir, int word_len)
+{
+    return (std::filesystem::path(dir) / ("dfs-" + wordLengthName(word_len) + ".ckpt")).string();
+}
+
+/*
+ * Splits the DFS checkpoint of every word length into --shards checkpoints, one directory per shard.
+ * A word length without a checkpoint is split from the start of its search.
+ * Returns false if a dictionary cannot be loaded or a shard cannot be written.
+ */
+bool shardCheckpoints(const options_t& opts)
+{
+    for (int len : opts.lengths) {
+        dictionary_t dict;
+        dict.rule = opts.rule;
+        if (!readWords(opts.dict_path, len, dict.words, opts.rule))
+            return false;
+        buildDictionary(dict);
+
+        dfs_state_t state;
+        std::string path = checkpointPath(opts.checkpoint_dir, len);
+        if (!loadDFSState(path, dict, opts.params.exact, state)) {
+            state = newDFSState(dict);
+            state.exact = opts.params.exact;
+        }
+
+        std::vector<dfs_state_t> shards = splitDFSState(state, opts.shards);
+        for (size_t k = 0; k < shards.size(); k++) {
+            std::filesystem::path dir = std::filesystem::path(opts.checkpoint_dir) / ("shard-" + std::to_string(k));
+            if (!saveDFSState(checkpointPath(dir.string(), len), dict, shards[k]))
+                return false;
+        }
+        std::cout << "Word length " << len << ": " << state.root_base / 2 << " root words left, split into "
+                  << shards.size() << " shards\n";
+    }
+    return true;
+}
+
+/* Word IDs of a path, sorted (the form pathDistance takes) */
+std::vector<uint32_t> sortedIds(const dictionary_t& dict, const std::list<std::string>& path)
+{
+    std::vector<uint32_t> ids;
+    for (const std::string& word : path)
+        ids.push_back(findWord(dict, word));
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+/*
+ * Executes the chosen algorithm on the current dictionary of a word length.
+ * With --cache, a search without a warm start path starts from the stored best path,
+ * and the path found is stored if it is longer.
+ * With constraints, a word length whose dictionary cannot meet them finds no sequence (and says why).
+ */
+void solveMaxSequence(const options_t& opts, solve_params_t params, job_t& job, result_t& result)
+{
+    path_constraints_t constraints;
+    if (isConstrained(opts.constraints)) {
+        std::string error;
+        if (resolveConstraints(job.dict, opts.constraints, constraints, error))
+            error = checkConstraints(job.dict, constraints);
+        if (!error.empty() && job.paths.empty())
+            std::cerr << "Word length " << wordLengthName(result.word_len) << ": " << error << '\n';
+        params.constraints = &constraints;
+        if (!error.empty()) {
+            job.paths.emplace_back();
+            return;
+        }
+    }
+
+    if (!opts.cache_dir.empty() && params.initial_path.empty())
+        params.initial_path = loadSolution(opts.cache_dir, job.dict);
+
+    // Only the search of the dictionary as loaded is checkpointed, not the re-solves after deltas.
+    if (!opts.checkpoint_dir.empty() && job.paths.empty())
+        params.checkpoint_path = checkpointPath(opts.checkpoint_dir, result.word_len);
+
+    // With --top, the search of the dictionary as loaded enumerates the top sequences on every thread.
+    bool top = opts.top > 0 && job.paths.empty();
+    solve_stats_t stats;
+    std::list<std::string> path;
+    result.found = measurePhase(opts, SearchPhase, result, [&]() {
+        if (top) {
+            job.top = solveTopK(opts.algo, job.dict, params, opts.top, opts.diversity, opts.threads,
+                                opts.seed + result.word_len, &stats);
+            if (!job.top.empty())
+                path = job.top.front();
+        } else {
+            path = solve(opts.algo, job.dict, params, &stats);
+        }
+    });
+    if (top) {
+        std::vector<uint32_t> first = sortedIds(job.dict, path);
+        for (const auto& sequence : job.top)
+            result.top_distance.push_back(pathDistance(first, sortedIds(job.dict, sequence)));
+    }
+    if (!opts.cache_dir.empty())
+        storeSolution(opts.cache_dir, job.dict, path);
+    result.total += result.found;
+    result.seq_length = path.size();
+    result.iterations = stats.iterations;
+    job.paths.push_back(std::move(path));
+}
+
+/*
+ * Applies a delta to a solved word length and re-solves it within --delta-time-limit, warm-started
+ * from the previous path repaired for the updated dictionary. A delta that changes no word
+ * keeps the repaired path without searching.
+ */
+void updateWordLength(const options_t& opts, const word_delta_t& delta, job_t& job, result_t& result)
+{
+    solve_params_t params = opts.params;
+    size_t changes = 0;
+    result.total = measurePhase(opts, BuildPhase, result, [&]() {
+        changes = applyDelta(job.dict, delta, result.word_len);
+        params.initial_path = repairPath(job.dict, job.paths.back());
+    });
+    result.num_words = numWords(job.dict.words);
+
+    if (changes == 0) {
+        // The repaired path is the previous one extended greedily at its ends. The extension may
+        // break constraints, so a constrained search keeps the previous path as it was.
+        std::list<std::string> path = (isConstrained(opts.constraints))
+                                      ? job.paths.back() : pathWords(job.dict.words, params.initial_path);
+        if (!opts.cache_dir.empty())
+            storeSolution(opts.cache_dir, job.dict, path);
+        result.seq_length = path.size();
+        job.paths.push_back(std::move(path));
+        return;
+    }
+
+    // The repaired path is close to the previous optimum, so the re-solve gets its own (short) budget.
+    params.time_limit = opts.delta_time_limit;
+    solveMaxSequence(opts, params, job, result);
+}
+
+void validateWordLength(const options_t& opts, job_t& job, result_t* results)
+{
+    for (size_t step = 0; step < job.paths.size(); step++) {
+        result_t& result = results[step];
+        measurePhase(opts, ValidatePhase, result, [&]() { result.correct = testPath(job.paths[step], opts.rule); });
+    }
+    for (const auto& sequence : job.top)
+        results[0].top_correct.push_back(testPath(sequence, opts.rule));
+    results[0].top = std::move(job.top);
+    job.paths.clear();
+}
+
+
+/* A word as a JSON string: quoted, with '"', '\\' and control characters escaped */
+std::string jsonString(std::string_view word)
+{
+    std::string out = "\"";
+    for (char c : word) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if ((unsigned char)c < 0x20) {
+            char code[7];
+            std::snprintf(code, sizeof(code), "\\u%04x", c);
+            out += code;
+        } else {
+            out += c;
+        }
+    }
+    return out + '"';
+}
+
+void printResults(const options_t& opts, const std::vector<result_t>& results)
+{
+    if (opts.output == Output::Table) {
+        std::cout << "Algorithm: " << algorithmName(opts.algo) << ", seed: " << opts.seed;
+        if (!isDefaultRule(opts.rule))
+            std::cout << ", rule: " << ruleName(opts.rule);
+        std::cout << "\n\n";
+        if (opts.deltas.empty()) {
+            TableFormat vt({"Word Length", "Num. Words", "Seq. Length", "CPU Found (sec)",
+                            "CPU Total (sec)", "Iterations", "Correct"});
+            for (const auto& r : results)
+                vt.addRow(wordLengthName(r.word_len), r.num_words, r.seq_length, r.found, r.total, r.iterations,
+                          (r.correct) ? "True" : "False");
+            vt.print(std::cout);
+        } else {
+            // CPU Total of a delta is the time to apply it, repair the path and re-solve.
+            DeltaTableFormat vt({"Word Length", "Delta", "Num. Words", "Seq. Length", "CPU Found (sec)",
+                                 "CPU Total (sec)", "Iterations", "Correct"});
+            for (const auto& r : results)
+                vt.addRow(wordLengthName(r.word_len), r.delta, r.num_words, r.seq_length, r.found, r.total, r.iterations,
+                          (r.correct) ? "True" : "False");
+            vt.print(std::cout);
+        }
+        std::cout << std::endl;
+
+        if (opts.top) {
+            // Distance to #1 is the share of words the two sequences do not have in common.
+            TopTableFormat tt({"Word Length", "Rank", "Seq. Length", "Distance to #1", "Correct"});
+            for (const auto& r : results) {
+                for (size_t i = 0; i < r.top.size(); i++)
+                    tt.addRow(wordLengthName(r.word_len), i + 1, r.top[i].size(), r.top_distance[i],
+                              (r.top_correct[i]) ? "True" : "False");
+            }
+            tt.print(std::cout);
+            std::cout << std::endl;
+        }
+
+        if (opts.perf) {
+            // Unavailable counters are shown as -1.
+            PerfTableFormat pt({"Word Length", "Phase", "Cycles", "Instructions", "Cache Misses",
+                                "Branch Misses", "Page Faults"});
+            for (const auto& r : results) {
+                for (int p = 0; p < NumPhases; p++) {
+                    long long v[NumPerfCounters];
+                    for (int c = 0; c < NumPerfCounters; c++)
+                        v[c] = (r.perf[p].available[c]) ? (long long)r.perf[p].values[c] : -1;
+                    pt.addRow(wordLengthName(r.word_len), phase_names[p], v[0], v[1], v[2], v[3], v[4]);
+                }
+            }
+            pt.print(std::cout);
+            std::cout << std::endl;
+        }
+
+        if (allocCountingEnabled()) {
+            // Per iteration counts are only meaningful for the search phase.
+            AllocTableFormat at({"Word Length", "Phase", "Allocations", "Frees", "Bytes",
+                                 "Allocs/Iteration", "Bytes/Iteration"});
+            for (const auto& r : results) {
+                for (int p = 0; p < NumPhases; p++) {
+                    const auto& a = r.allocs[p];
+                    size_t its = (p == SearchPhase) ? r.iterations : 0;
+                    at.addRow(wordLengthName(r.word_len), phase_names[p], a.allocations, a.frees, a.bytes,
+                              (its) ? (double)a.allocations / its : 0.0,
+                              (its) ? (double)a.bytes / its : 0.0);
+                }
+            }
+            at.print(std::cout);
+            std::cout << std::endl;
+        }
+    } else if (opts.output == Output::CSV) {
+        // With --perf, every phase and counter gets a column (empty if unavailable).
+        std::cout << "algo,seed,word_len," << ((opts.deltas.empty()) ? "" : "delta,") << "num_words,seq_length,found_sec,total_sec,iterations,correct";
+        if (opts.top)
+            std::cout << ",top_lengths";
+        if (opts.perf) {
+            for (int p = 0; p < NumPhases; p++)
+                for (int c = 0; c < NumPerfCounters; c++)
+                    std::cout << ',' << phase_names[p] << '_' << perfCounterName(c);
+        }
+        if (allocCountingEnabled()) {
+            for (int p = 0; p < NumPhases; p++)
+                std::cout << ',' << phase_names[p] << "_allocations," << phase_names[p] << "_bytes";
+            std::cout << ",allocations_per_iteration,bytes_per_iteration";
+        }
+        std::cout << '\n';
+        for (const auto& r : results) {
+            std::cout << algorithmName(opts.algo) << ',' << opts.seed << ',' << wordLengthName(r.word_len) << ',';
+            if (!opts.deltas.empty())
+                std::cout << r.delta << ',';
+            std::cout << r.num_words << ',' << r.seq_length << ',' << r.found << ',' << r.total << ','
+                      << r.iterations << ',' << ((r.correct) ? "true" : "false");
+            if (opts.top) {
+                // Lengths of the top sequences, longest first, separated by ';'.
+                std::cout << ',';
+                for (size_t i = 0; i < r.top.size(); i++)
+                    std::cout << ((i) ? ";" : "") << r.top[i].size();
+            }
+            if (opts.perf) {
+                for (int p = 0; p < NumPhases; p++) {
+                    for (int c = 0; c < NumPerfCounters; c++) {
+                        std::cout << ',';
+                        if (r.perf[p].available[c]) std::cout << r.perf[p].values[c];
+                    }
+                }
+            }
+            if (allocCountingEnabled()) {
+                for (int p = 0; p < NumPhases; p++)
+                    std::cout << ',' << r.allocs[p].allocations << ',' << r.allocs[p].bytes;
+                const auto& a = r.allocs[SearchPhase];
+                std::cout << ',' << ((r.iterations) ? (double)a.allocations / r.iterations : 0.0)
+                          << ',' << ((r.iterations) ? (double)a.bytes / r.iterations : 0.0);
+            }
+            std::cout << '\n';
+        }
+    } else {
+        std::cout << "{\"algo\": \"" << algorithmName(opts.algo) << "\", \"seed\": " << opts.seed
+                  << ", \"rule\": \"" << ruleName(opts.rule) << "\""
+                  << ", \"results\": [";
+        for (size_t i = 0; i < results.size(); i++) {
+            const auto& r = results[i];
+            std::cout << ((i) ? ", " : "") << "{\"word_len\": ";
+            if (r.word_len == MixedWordLength)
+                std::cout << "\"mixed\"";
+            else
+                std::cout << r.word_len;
+            if (!opts.deltas.empty())
+                std::cout << ", \"delta\": " << r.delta;
+            std::cout << ", \"num_words\": " << r.num_words << ", \"seq_length\": " << r.seq_length
+                      << ", \"found_sec\": " << r.found << ", \"total_sec\": " << r.total
+                      << ", \"iterations\": " << r.iterations
+                      << ", \"correct\": " << ((r.correct) ? "true" : "false");
+            if (opts.top) {
+                std::cout << ", \"top\": [";
+                for (size_t t = 0; t < r.top.size(); t++) {
+                    std::cout << ((t) ? ", " : "") << "{\"length\": " << r.top[t].size()
+                              << ", \"distance\": " << r.top_distance[t]
+                              << ", \"correct\": " << ((r.top_correct[t]) ? "true" : "false") << ", \"words\": [";
+                    bool first = true;
+                    for (const std::string& word : r.top[t]) {
+                        std::cout << ((first) ? "" : ", ") << jsonString(word);
+                        first = false;
+                    }
+                    std::cout << "]}";
+                }
+                std::cout << "]";
+            }
+            if (opts.perf) {
+                // Unavailable counters are null.
+                std::cout << ", \"perf\": {";
+                for (int p = 0; p < NumPhases; p++) {
+                    std::cout << ((p) ? ", " : "") << "\"" << phase_names[p] << "\": {";
+                    for (int c = 0; c < NumPerfCounters; c++) {
+                        std::cout << ((c) ? ", " : "") << "\"" << perfCounterName(c) << "\": ";
+                        if (r.perf[p].available[c]) std::cout << r.perf[p].values[c];
+                        else std::cout << "null";
+                    }
+                    std::cout << "}";
+                }
+                std::cout << "}";
+            }
+            if (allocCountingEnabled()) {
+                std::cout << ", \"allocs\": {";
+                for (int p = 0; p < NumPhases; p++) {
+                    const auto& a = r.allocs[p];
+                    std::cout << ((p) ? ", " : "") << "\"" << phase_names[p] << "\": {\"allocations\": "
+                              << a.allocations << ", \"frees\": " << a.frees << ", \"bytes\": " << a.bytes << "}";
+                }
+                const auto& a = r.allocs[SearchPhase];
+                std::cout << ", \"allocations_per_iteration\": "
+                          << ((r.iterations) ? (double)a.allocations / r.iterations : 0.0)
+                          << ", \"bytes_per_iteration\": "
+                          << ((r.iterations) ? (double)a.bytes / r.iterations : 0.0) << "}";
+            }
+            std::cout << "}";
+        }
+        std::cout << "]}" << std::endl;
+    }
+}
+
+
+int main(int argc, char* argv[])
+{
+    options_t opts;
+    if (!parseOptions(argc, argv, opts)) {
+        printUsage(std::cerr);
+        return 1;
+    }
+
+    if (opts.shards)
+        return (shardCheckpoints(opts)) ? 0 : 1;
+
+    std::vector<word_delta_t> deltas(opts.deltas.size());
+    for (size_t d = 0; d < deltas.size(); d++) {
+        if (!readDelta(opts.deltas[d], deltas[d]))
+            return 1;
+    }
+
+    // Solve the word lengths on a pool of threads, each taking the next loaded length, while
+    // another thread loads up to --prefetch lengths ahead and validates finished ones.
+    // Each length has a result for its dictionary and one after every delta.
+    size_t num_lengths = opts.lengths.size();
+    size_t steps = 1 + deltas.size();
+    std::vector<result_t> results(num_lengths * steps);
+    std::vector<job_t> jobs(num_lengths);
+    // With --top, the threads enumerate the sequences of one word length at a time instead.
+    bool ok = runPipeline(num_lengths, (opts.top) ? 1 : opts.threads, opts.prefetch,
+        [&](size_t i) { return loadWordLength(opts.lengths[i], opts, jobs[i], results[i * steps]); },
+        [&](size_t i) {
+            // Each word length gets its own seed so results do not depend on the thread count
+            // or on which thread loaded the dictionary.
+            seedRandom(opts.seed + opts.lengths[i]);
+            solveMaxSequence(opts, opts.params, jobs[i], results[i * steps]);
+            for (size_t d = 0; d < deltas.size(); d++) {
+                result_t& result = results[i * steps + d + 1];
+                result.word_len = opts.lengths[i];
+                result.delta = d + 1;
+                updateWordLength(opts, deltas[d], jobs[i], result);
+            }
+            jobs[i].dict = dictionary_t();
+        },
+        [&](size_t i) { validateWordLength(opts, jobs[i], &results[i * steps]); });
+
+    if (!ok)
+        return 1;
+
+    printResults(opts, results);
+    return 0;
+}
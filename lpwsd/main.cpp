@@ -0,0 +1,536 @@
+#include <iostream>
+#include <sstream>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <map>
+#include <set>
+#include <memory>
+#include <csignal>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <unistd.h>
+#include "../local_search/common/Dictionary.h"
+#include "../local_search/common/Solvers.h"
+#include "../local_search/common/Constraints.h"
+
+/*
+ * Solver daemon. Keeps the dictionary of every word length it has been asked about, and the
+ * best path found for it, in memory and answers requests over a Unix domain socket.
+ * Requests are single lines, each answered by a single line (LEN is a word length, or "mixed" for all lengths):
+ *   solve LEN [algo=NAME] [time=SEC] [seed=N]  ->  ok SEQ_LENGTH SECONDS WORD...
+ *     [start=WORD] [end=WORD] [require=W,W,...] [forbid=W,W,...] [lns-workers=N]
+ *   best LEN                                   ->  ok SEQ_LENGTH WORD...
+ *   validate WORD...                           ->  ok true|false
+ * validate checks the words are in the dictionary of their length (the mixed dictionary if their lengths
+ * differ) and form a sequence.
+ * Failed requests are answered with "error REASON".
+ * Solves run on a pool of worker threads. "time" is the request's deadline, counted from when it
+ * is received: a request still queued at its deadline fails, otherwise the search gets what is left.
+ * Local searches are warm-started from the best path known for the word length.
+ * start, end, require and forbid constrain the sequence (see Constraints.h), a solve that cannot
+ * meet them fails with the reason. lns-workers sets the threads of an lns solve, at most one per core.
+ *
+ * Build with : cmake -S . -B build && cmake --build build --target lpwsd
+ */
+
+/* Dictionary file (the build sets this to the repository's dictionary.txt) */
+#ifndef DICTIONARY_PATH
+#define DICTIONARY_PATH "dictionary.txt"
+#endif
+
+/* Chrono clock */
+typedef std::chrono::steady_clock Clock;
+
+/* Command line options */
+struct options_t {
+    std::string socket_path = "/tmp/lpwsd.sock";
+    std::string dict_path = DICTIONARY_PATH;
+    int workers = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<int> preload;
+    overlap_rule_t rule;
+    double time_limit = 1;
+    solve_params_t params;
+};
+
+/* Dictionary and best path of one word length, loaded on first use */
+struct length_state_t {
+    std::mutex mutex;
+    bool loaded = false;
+    dictionary_t dict; // read only once loaded.
+    std::list<std::string> best;
+};
+
+/* A solve request waiting for a worker */
+struct request_t {
+    std::vector<std::string> args;
+    Clock::time_point deadline;
+    std::promise<std::string> reply;
+};
+
+/* State shared by the acceptor, connection and worker threads */
+struct server_t {
+    options_t opts;
+
+    std::mutex lengths_mutex;
+    std::map<int, std::unique_ptr<length_state_t>> lengths;
+
+    std::mutex queue_mutex;
+    std::condition_variable queue_cv;
+    std::deque<request_t> queue;
+    bool stopping = false;
+
+    std::mutex clients_mutex;
+    std::condition_variable clients_cv;
+    std::set<int> clients;
+};
+
+/* Set by SIGINT/SIGTERM */
+static volatile std::sig_atomic_t stop_requested = 0;
+
+static void onStopSignal(int)
+{
+    stop_requested = 1;
+}
+
+
+void printUsage(std::ostream& out)
+{
+    out << "Usage: lpwsd [options]\n"
+        << "  --socket PATH         Unix socket to listen on (default: /tmp/lpwsd.sock)\n"
+        << "  --dict PATH           dictionary file (default: " DICTIONARY_PATH ")\n"
+        << "  --workers N           solves run concurrently (default: number of cores)\n"
+        << "  --preload LIST        word lengths to load at startup, e.g. 4-15 (default: none)\n"
+        << "  --rule NAME           overlap rule: default, overlap3, first-last or kK-fF-bB[-i] (default: default)\n"
+        << "  --time-limit SEC      deadline of a solve request without time= (default: 1)\n"
+        << "  --max-attempts N      hill, random-greedy and lns failed attempts before stopping (default: 1000)\n"
+        << "  --sample MODE         restart word distribution, uniform or degree (default: uniform)\n";
+}
+
+/*
+ * Parses the command line into opts.
+ * Returns false (after printing the reason) if the command line is invalid.
+ */
+bool parseOptions(int argc, char* argv[], options_t& opts)
+{
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage(std::cout);
+            std::exit(0);
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << '\n';
+            return false;
+        }
+        std::string value = argv[++i];
+
+        try {
+            if (arg == "--socket") {
+                opts.socket_path = value;
+            } else if (arg == "--dict") {
+                opts.dict_path = value;
+            } else if (arg == "--workers") {
+                opts.workers = std::max(1, std::stoi(value));
+            } else if (arg == "--preload") {
+                if (!parseLengths(value, opts.preload)) {
+                    std::cerr << "Invalid word lengths: " << value << '\n';
+                    return false;
+                }
+            } else if (arg == "--rule") {
+                if (!parseRule(value, opts.rule)) {
+                    std::cerr << "Invalid overlap rule: " << value << '\n';
+                    return false;
+                }
+            } else if (arg == "--time-limit") {
+                opts.time_limit = std::stod(value);
+            } else if (arg == "--max-attempts") {
+                opts.params.max_attempts = std::stoul(value);
+            } else if (arg == "--sample") {
+                if (value == "uniform") opts.params.sample_mode = SampleMode::Uniform;
+                else if (value == "degree") opts.params.sample_mode = SampleMode::Degree;
+                else {
+                    std::cerr << "Unknown sample mode: " << value << '\n';
+                    return false;
+                }
+            } else {
+                std::cerr << "Unknown option: " << arg << '\n';
+                return false;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Invalid value for " << arg << ": " << value << '\n';
+            return false;
+        }
+    }
+    return true;
+}
+
+
+/* ------------------ Word Lengths ------------------------- */
+
+
+/*
+ * Returns the state of a word length, loading its dictionary on first use
+ * (concurrent requests for the length wait for the one loading it).
+ * Returns nullptr if the dictionary cannot be read.
+ */
+length_state_t* wordLength(server_t& server, int word_len)
+{
+    length_state_t* state;
+    {
+        std::lock_guard<std::mutex> lock(server.lengths_mutex);
+        auto& slot = server.lengths[word_len];
+        if (!slot)
+            slot = std::make_unique<length_state_t>();
+        state = slot.get();
+    }
+
+    std::lock_guard<std::mutex> lock(state->mutex);
+    if (!state->loaded) {
+        state->dict.rule = server.opts.rule;
+        state->loaded = loadDictionary(server.opts.dict_path, state->dict, word_len) >= 0;
+    }
+    return (state->loaded) ? state : nullptr;
+}
+
+/* Parses the LEN argument of a request, throws std::invalid_argument if it is not a word length */
+int wordLengthArg(const std::string& arg)
+{
+    std::vector<int> lengths;
+    if (!parseLengths(arg, lengths) || lengths.size() != 1)
+        throw std::invalid_argument(arg);
+    return lengths[0];
+}
+
+/* Formats a reply holding a path */
+std::string pathReply(const std::list<std::string>& path, const std::string& fields)
+{
+    std::string reply = "ok " + std::to_string(path.size()) + fields;
+    for (const std::string& word : path)
+        reply += ' ' + word;
+    return reply;
+}
+
+
+/* ------------------ Requests ------------------------- */
+
+
+/*
+ * Runs a solve request (on a worker thread).
+ * args: "solve" LEN [algo=NAME] [time=SEC] [seed=N] [start=WORD] [end=WORD] [require=LIST] [forbid=LIST]
+ *   [lns-workers=N],
+ * time has already set the deadline.
+ */
+std::string handleSolve(server_t& server, const std::vector<std::string>& args, Clock::time_point deadline)
+{
+    Algorithm algo = Algorithm::SimulatedAnnealing;
+    uint32_t seed = std::random_device{}();
+    constraint_words_t words;
+    int lns_workers = server.opts.params.workers;
+    int word_len;
+    try {
+        word_len = wordLengthArg(args.at(1));
+        for (size_t i = 2; i < args.size(); i++) {
+            size_t eq = args[i].find('=');
+            std::string key = args[i].substr(0, eq);
+            std::string value = (eq == std::string::npos) ? "" : args[i].substr(eq + 1);
+            if (key == "algo") {
+                if (!parseAlgorithm(value, algo))
+                    return "error unknown algorithm: " + value;
+            } else if (key == "seed") {
+                seed = std::stoul(value);
+            } else if (key == "start") {
+                words.start = value;
+            } else if (key == "end") {
+                words.end = value;
+            } else if (key == "require") {
+                words.required = splitWords(value);
+            } else if (key == "forbid") {
+                words.forbidden = splitWords(value);
+            } else if (key == "lns-workers") {
+                int cores = std::max(1u, std::thread::hardware_concurrency());
+                lns_workers = std::min(std::max(1, std::stoi(value)), cores);
+            } else if (key != "time") {
+                return "error unknown argument: " + args[i];
+            }
+        }
+    } catch (const std::exception&) {
+        return "error usage: solve LEN [algo=NAME] [time=SEC] [seed=N] [start=WORD] [end=WORD] [require=LIST] [forbid=LIST]"
+               " [lns-workers=N]";
+    }
+
+    length_state_t* state = wordLength(server, word_len);
+    if (!state)
+        return "error cannot read the dictionary";
+
+    path_constraints_t constraints;
+    if (isConstrained(words)) {
+        std::string error;
+        if (resolveConstraints(state->dict, words, constraints, error))
+            error = checkConstraints(state->dict, constraints);
+        if (!error.empty())
+            return "error " + error;
+    }
+
+    // The search gets whatever is left of the deadline after queueing (and loading).
+    double remaining = std::chrono::duration<double>(deadline - Clock::now()).count();
+    if (remaining <= 0)
+        return "error deadline exceeded";
+
+    solve_params_t params = server.opts.params;
+    params.time_limit = remaining;
+    params.workers = lns_workers;
+    if (isConstrained(words))
+        params.constraints = &constraints;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (!state->best.empty() && algo != Algorithm::DFS && algo != Algorithm::Greedy)
+            params.initial_path = repairPath(state->dict, state->best);
+    }
+
+    seedRandom(seed);
+    auto start = Clock::now();
+    std::list<std::string> path = solve(algo, state->dict, params);
+    double found = std::chrono::duration<double>(Clock::now() - start).count();
+
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (path.size() > state->best.size())
+            state->best = path;
+    }
+    return pathReply(path, " " + std::to_string(found));
+}
+
+/* Worker thread: runs queued solve requests until the server stops */
+void runWorker(server_t& server)
+{
+    while (true) {
+        std::unique_lock<std::mutex> lock(server.queue_mutex);
+        server.queue_cv.wait(lock, [&]() { return !server.queue.empty() || server.stopping; });
+        if (server.queue.empty())
+            return;
+
+        request_t request = std::move(server.queue.front());
+        server.queue.pop_front();
+        lock.unlock();
+
+        if (Clock::now() >= request.deadline)
+            request.reply.set_value("error deadline exceeded");
+        else
+            request.reply.set_value(handleSolve(server, request.args, request.deadline));
+    }
+}
+
+/*
+ * Answers one request line. Solves are queued for the worker pool, the
+ * other requests are cheap and answered on the connection's thread.
+ */
+std::string handleRequest(server_t& server, const std::string& line)
+{
+    std::istringstream ss(line);
+    std::vector<std::string> args;
+    std::string token;
+    while (ss >> token)
+        args.push_back(token);
+    if (args.empty())
+        return "error empty request";
+
+    if (args[0] == "validate") {
+        std::list<std::string> path(args.begin() + 1, args.end());
+        if (path.empty())
+            return "ok true";
+        int word_len = path.front().size();
+        for (const std::string& word : path) {
+            if ((int)word.size() != word_len)
+                word_len = MixedWordLength;
+        }
+        length_state_t* state = wordLength(server, word_len);
+        if (!state)
+            return "error cannot read the dictionary";
+        for (const std::string& word : path) {
+            if (findWord(state->dict, word) < 0)
+                return "ok false";
+        }
+        return (testPath(path, server.opts.rule)) ? "ok true" : "ok false";
+    }
+
+    if (args[0] == "best") {
+        int word_len;
+        try {
+            word_len = wordLengthArg(args.at(1));
+        } catch (const std::exception&) {
+            return "error usage: best LEN";
+        }
+        length_state_t* state = wordLength(server, word_len);
+        if (!state)
+            return "error cannot read the dictionary";
+        std::lock_guard<std::mutex> lock(state->mutex);
+        return pathReply(state->best, "");
+    }
+
+    if (args[0] == "solve") {
+        double time_limit = server.opts.time_limit;
+        for (const std::string& arg : args) {
+            if (arg.compare(0, 5, "time=") == 0) {
+                try {
+                    time_limit = std::stod(arg.substr(5));
+                } catch (const std::exception&) {
+                    return "error invalid time: " + arg;
+                }
+            }
+        }
+
+        request_t request;
+        request.args = std::move(args);
+        request.deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>(
+                std::chrono::duration<double>(time_limit));
+        std::future<std::string> reply = request.reply.get_future();
+        {
+            std::lock_guard<std::mutex> lock(server.queue_mutex);
+            if (server.stopping)
+                return "error shutting down";
+            server.queue.push_back(std::move(request));
+        }
+        server.queue_cv.notify_one();
+        return reply.get();
+    }
+
+    return "error unknown request: " + args[0];
+}
+
+
+/* ------------------ Connections ------------------------- */
+
+
+/* Writes all of data to a socket. Returns false if the client has gone away */
+bool sendAll(int fd, const std::string& data)
+{
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0)
+            return false;
+        sent += n;
+    }
+    return true;
+}
+
+/* Connection thread: answers the client's requests, in order, until it disconnects */
+void serveClient(server_t& server, int fd)
+{
+    std::string buffer;
+    char chunk[4096];
+    ssize_t n;
+    bool open = true;
+    while (open && (n = read(fd, chunk, sizeof(chunk))) > 0) {
+        buffer.append(chunk, n);
+        size_t end;
+        while (open && (end = buffer.find('\n')) != std::string::npos) {
+            std::string line = buffer.substr(0, end);
+            buffer.erase(0, end + 1);
+            open = sendAll(fd, handleRequest(server, line) + '\n');
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(server.clients_mutex);
+    server.clients.erase(fd);
+    close(fd);
+    server.clients_cv.notify_all();
+}
+
+/* Creates the listening socket. Returns -1 (after printing the reason) on failure */
+int listenOn(const std::string& path)
+{
+    sockaddr_un addr{};
+    if (path.size() >= sizeof(addr.sun_path)) {
+        std::cerr << "Socket path too long: " << path << '\n';
+        return -1;
+    }
+    addr.sun_family = AF_UNIX;
+    std::strcpy(addr.sun_path, path.c_str());
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        std::cerr << "socket: " << std::strerror(errno) << '\n';
+        return -1;
+    }
+
+    // Replace the socket file of a previous run.
+    unlink(path.c_str());
+    if (bind(fd, (sockaddr*)&addr, sizeof(addr)) < 0 || listen(fd, 64) < 0) {
+        std::cerr << "Cannot listen on " << path << ": " << std::strerror(errno) << '\n';
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+
+int main(int argc, char* argv[])
+{
+    server_t server;
+    if (!parseOptions(argc, argv, server.opts)) {
+        printUsage(std::cerr);
+        return 1;
+    }
+
+    for (int word_len : server.opts.preload) {
+        if (!wordLength(server, word_len))
+            return 1;
+    }
+
+    int listen_fd = listenOn(server.opts.socket_path);
+    if (listen_fd < 0)
+        return 1;
+
+    std::signal(SIGINT, onStopSignal);
+    std::signal(SIGTERM, onStopSignal);
+
+    std::vector<std::thread> workers;
+    for (int i = 0; i < server.opts.workers; i++)
+        workers.emplace_back(runWorker, std::ref(server));
+
+    std::cout << "Listening on " << server.opts.socket_path << " with "
+              << server.opts.workers << " workers" << std::endl;
+
+    // Accept clients until stopped, polling so that a signal is noticed promptly.
+    while (!stop_requested) {
+        pollfd pfd = {listen_fd, POLLIN, 0};
+        if (poll(&pfd, 1, 200) <= 0)
+            continue;
+
+        int fd = accept(listen_fd, nullptr, nullptr);
+        if (fd < 0)
+            continue;
+        {
+            std::lock_guard<std::mutex> lock(server.clients_mutex);
+            server.clients.insert(fd);
+        }
+        std::thread(serveClient, std::ref(server), fd).detach();
+    }
+
+    // Stop accepting, fail queued solves, let running ones finish, then disconnect every client.
+    close(listen_fd);
+    unlink(server.opts.socket_path.c_str());
+    {
+        std::lock_guard<std::mutex> lock(server.queue_mutex);
+        server.stopping = true;
+        for (auto& request : server.queue)
+            request.reply.set_value("error shutting down");
+        server.queue.clear();
+    }
+    server.queue_cv.notify_all();
+    for (auto& t : workers)
+        t.join();
+
+    std::unique_lock<std::mutex> lock(server.clients_mutex);
+    for (int fd : server.clients)
+        shutdown(fd, SHUT_RDWR);
+    server.clients_cv.wait(lock, [&]() { return server.clients.empty(); });
+    return 0;
+}
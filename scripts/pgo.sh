@@ -0,0 +1,30 @@
+#!/bin/sh
+# Profile guided optimisation build.
+# Builds instrumented binaries, trains them on the 4..15 sweep of every engine,
+# then rebuilds with the recorded profile.
+#
+# Usage: scripts/pgo.sh [build dir] [seconds per word length]
+set -e
+
+SRC_DIR=$(cd "$(dirname "$0")/.." && pwd)
+BUILD_DIR=${1:-$SRC_DIR/build-pgo}
+TIME_LIMIT=${2:-1}
+PROFILE_DIR=$BUILD_DIR/pgo-profile
+
+rm -rf "$PROFILE_DIR"
+
+# 1. Instrumented build.
+cmake -S "$SRC_DIR" -B "$BUILD_DIR" -DCMAKE_BUILD_TYPE=Release -DLPWS_LTO=ON \
+      -DLPWS_PGO=GENERATE -DLPWS_PGO_DIR="$PROFILE_DIR"
+cmake --build "$BUILD_DIR" --target lpws -j
+
+# 2. Training run: the 4..15 sweep for every engine.
+for algo in dfs greedy hill sa random-greedy lns; do
+    "$BUILD_DIR/bin/lpws" --algo "$algo" --lengths 4-15 --time-limit "$TIME_LIMIT" --seed 1 --output csv
+done
+
+# 3. Optimised rebuild of every target using the profile.
+cmake -S "$SRC_DIR" -B "$BUILD_DIR" -DLPWS_PGO=USE
+cmake --build "$BUILD_DIR" --clean-first -j
+
+echo "PGO build finished: $BUILD_DIR/bin"